@@ -1,210 +1,573 @@
 #include "platform.h"       // Provides CLK_FREQ, ADC_MASK, and pin definitions (e.g., P_ADC)
-#include "adc.h"            // ADC driver functions: adc_init() and adc_read()
+#include "adc.h"            // ADC_RESULT()
 #include "gpio.h"           // GPIO functions: gpio_set_mode() and gpio_set()
-#include "delay.h"          // Delay functions: delay_ms(), delay_us(), etc.
-#include "lcd.h"            // LCD driver functions: lcd_init(), lcd_clear(), lcd_print(), lcd_set_cursor()
+#include "lcd.h"            // LCD driver functions: lcd_init(), lcd_clear(), lcd_fb_print(), lcd_fb_flush()
+#include "sampler.h"        // Timer-paced ADC sampling into DMA ping-pong buffers
+#include "goertzel.h"       // Block tone power
+#include "envelope.h"       // Per-sample sliding window envelope
+#include "bandpass.h"       // CMSIS-DSP band-pass pre-filter
+#include "fixed.h"          // Q15/Q30 formats of the signal path
+#include "noise.h"          // Midpoint, noise floor and adaptive thresholds
+#include "edges.h"          // Comparator edge timestamps
+#include "freqmeter.h"      // Capture-based tone frequency
+#include "morse.h"          // Code tree lookup
+#include "events.h"         // Mark/space event queue between front end and decoder
+#include "decoder.h"        // Morse timing state machine, one per signal
+#include "scheduler.h"      // Run-to-completion tasks
+#include "uart.h"           // Decoded text out on UART0
+#include "idle.h"           // Sleep with the ADC off until a tone or switch press
+#include "timebase.h"       // Idle timeout and wake-up latency
 #include "adc_conversion.h"
-#include <stdio.h>          // For sprintf()
-#include <string.h>         // For string operations
 #include "switches.h"
 
-#define VREF 3.3            // ADC reference voltage in volts
-
 #ifndef P_LED_R
   #define P_LED_R P1_11
 #endif
 
 #define LED_ON  0
 #define LED_OFF 1
-#define ALPHA 0.1f
-#define CLK 30
-#define THRESHOLD 50
-    #define BASE 2000
-    #define DOT_DURATION 1
-    #define DASH_DURATION 3
-    #define SYMBOL_GAP 3
-    #define WORD_GAP 7
-
-
-
-
-int calc_movingAverage() {
-    long long sum = 0;
-    for(int i = 0; i < CLK; i++) {
-        sum += adc_read();
-				delay_100us_low_power(1);
-    }
-    return sum / CLK;
-}
-
-char morse_to_char(const char* symbol) {
-    struct {
-        const char* code;
-        char letter;
-    } morse_table[] = {
-        {".-", 'A'}, {"-...", 'B'}, {"-.-.", 'C'}, {"-..", 'D'}, {"." , 'E'},
-        {"..-.", 'F'}, {"--.", 'G'}, {"....", 'H'}, {"..", 'I'}, {".---", 'J'},
-        {"-.-", 'K'}, {".-..", 'L'}, {"--", 'M'}, {"-.", 'N'}, {"---", 'O'},
-        {".--.", 'P'}, {"--.-", 'Q'}, {".-.", 'R'}, {"...", 'S'}, {"-", 'T'},
-        {"..-", 'U'}, {"...-", 'V'}, {".--", 'W'}, {"-..-", 'X'}, {"-.--", 'Y'}, {"--..", 'Z'},
-        {".----", '1'}, {"..---", '2'}, {"...--", '3'}, {"....-", '4'}, {".....", '5'},
-        {"-....", '6'}, {"--...", '7'}, {"---..", '8'}, {"----.", '9'}, {"-----", '0'},
-        {".-.-.-", '.'}, {"--..--", ','}, {"---...", ':'}, {"..--..", '?'},
-        {".----.", '\''}, {"-....-", '-'}, {"-..-.", '/'}, {"-.--.", '('}, {"-.--.-", ')'},
-        {".-..-.", '"'}, {"-...-", '='}, {".-.-.", '+'}, {"...-.-", '!'},
-        {"-.-", '^'}, {".-...", '~'}, {"........", '#'}, {"...-.", '_'},
-        {".--.-.", '@'}, {"-..-", '*'}
-    };
-
-    for (int i = 0; i < sizeof(morse_table)/sizeof(morse_table[0]); i++) {
-        if (strcmp(symbol, morse_table[i].code) == 0) {
-            return morse_table[i].letter;
-        }
+#define SAMPLE_RATE 8000    // Hz, one DMA_BUFFER_SIZE block every 16 ms
+#define US_PER_SAMPLE (1000000 / SAMPLE_RATE)
+#define ACQUISITION_BURST 0 // 1: ADC burst mode + interrupt ring, 0: TIMER0 + DMA
+#define EDGE_DETECTION 0    // 1: comparator edges only, ADC off; 0: ADC signal path
+#define FREQ_METER 0        // 1: tune the pre-filter from the capture frequency meter
+#define MULTI_CHANNEL 0     // 1: one decoder per Goertzel bin, 0: one decoder on the locked tone
+#define CHANNELS (MULTI_CHANNEL ? GOERTZEL_BINS : 1)
+#define UART_OUTPUT 1       // 1: stream the decoded words of the shown channel on UART0
+#define UART_BAUD 115200
+#define LCD_TIMING 0        // 1: time a redraw of the whole LCD at start-up and report it, to compare LCD_BACKEND settings
+
+#if SAMPLE_RATE != GOERTZEL_FS
+#error "The Goertzel and band-pass coefficient tables are computed for GOERTZEL_FS"
+#endif
+
+// Task rates, the sampling and decode tasks otherwise run when posted
+#define BURST_DRAIN_US (DMA_BUFFER_SIZE * US_PER_SAMPLE / 2) // Twice per block
+#define DISPLAY_PERIOD_US 100000
+#define UART_PERIOD_US 20000
+#define RATE_PERIOD_US 60000000 // Window of the per-channel character rates reported on UART0
+#define IDLE_CHECK_US 1000000
+#define IDLE_TIMEOUT_US 30000000 // Silence before the ADC is switched off and the CPU sleeps, 0: never
+
+// Bins spanning 300-800 Hz, locked onto the strongest tone
+static GoertzelBank tone_bank;
+static BandPass prefilter;
+static Envelope envelope;
+static NoiseTracker noise;
+static int previous_tone = 0;
+
+// Mark/space run being timed by the sample clock
+static int run_mark = 0;
+static uint32_t run_us = 0;
+
+// Wake-up from idle, timed until the first block is processed
+static int waking = 0;
+static uint32_t wake_at = 0;
+static uint32_t wake_latency_us = 0;
+static int wake_report = 0;
+
+#if MULTI_CHANNEL
+// Per-channel noise floors, only their tone power is used
+static NoiseTracker channel_noise[CHANNELS];
+
+// Channelizer: every Goertzel bin keys its own decoder, timed in whole
+// blocks. A bin is a mark while its power clears its own noise floor and
+// it is a local maximum of the bank, so that the leakage of a strong tone
+// into the neighbouring bins is not decoded as well.
+static void channelize(const GoertzelBank *bank, int raw_mean, int length) {
+    for (int k = 0; k < CHANNELS; k++) {
+        uint32_t power = bank->power[k];
+        int peak = (k == 0 || power >= bank->power[k - 1]) &&
+                   (k == CHANNELS - 1 || power >= bank->power[k + 1]);
+        int mark = !noise_calibrating(&channel_noise[k]) && peak &&
+                   power > noise_tone_threshold(&channel_noise[k]);
+
+        noise_update(&channel_noise[k], raw_mean, 0, power, !mark);
+        events_push(k, mark, length * US_PER_SAMPLE);
+    }
+}
+#endif
+
+// Band-pass bin for the current tone: the measured frequency when the
+// capture meter sees one inside the bank's range, else the locked bin.
+static int prefilter_bin(void) {
+#if FREQ_METER
+    int hz = freqmeter_hz();
+    if (hz >= GOERTZEL_F_MIN - GOERTZEL_F_STEP / 2 && hz < GOERTZEL_F_MAX + GOERTZEL_F_STEP / 2) {
+        return GOERTZEL_BIN(hz + GOERTZEL_F_STEP / 2);
     }
-    return '#';
+#endif
+    return tone_bank.locked < 0 ? BANDPASS_WIDE : tone_bank.locked;
 }
 
-int wait_for_start_signal(void) {
+// Runs once per block: removes the tracked DC midpoint, runs the filter
+// bank to qualify the block as tone, band-passes the block around the
+// locked bin and tracks the envelope of every filtered sample so that
+// on/off timing is resolved at the full sample rate. The resulting marks
+// and spaces are timed in samples and queued as events; the run still
+// open at the end of the block is queued too, so that the decoder sees
+// gaps as they grow. Idle blocks update the noise floor that the
+// thresholds are derived from.
+static void on_sample_block(const uint32_t *block, int length) {
+    if (waking) {
+        wake_latency_us = timebase_now_us() - wake_at;
+        waking = 0;
+        wake_report = 1;
+    }
 
-    while (1) {
-        int averagedSample = calc_movingAverage();
-        int signal_active = (averagedSample > (BASE + THRESHOLD));
+    q15_t samples[DMA_BUFFER_SIZE];
+    int midpoint = noise_midpoint(&noise);
+    uint32_t raw_sum = 0;
+    for (int i = 0; i < length; i++) {
+        int raw = ADC_RESULT(block[i]);
+        raw_sum += raw;
+        samples[i] = Q15_FROM_ADC(raw, midpoint);
+    }
+
+    uint32_t tone_threshold = noise_tone_threshold(&noise);
+    goertzel_bank_process(&tone_bank, samples, length, tone_threshold);
+    uint32_t power = goertzel_bank_tone_power(&tone_bank);
+    int tone = !noise_calibrating(&noise) && power > tone_threshold;
+
+#if MULTI_CHANNEL
+    // Only the DC midpoint is tracked here, a tone does not move it
+    noise_update(&noise, raw_sum / length, 0, 0, 1);
+    channelize(&tone_bank, raw_sum / length, length);
+    return;
+#endif
 
-        if (signal_active) {
-            return 0; // Signal detected, exit waiting loop
+    q15_t filtered[DMA_BUFFER_SIZE];
+    bandpass_tune(&prefilter, prefilter_bin());
+    bandpass_process(&prefilter, samples, filtered, length);
+
+    // A tone starting or ending mid-block may not reach the threshold in
+    // that block, so the previous block also qualifies it.
+    int block_tone = tone || previous_tone;
+    q15_t env_on = noise_env_on(&noise);
+    q15_t env_off = noise_env_off(&noise);
+
+    int32_t env_sum = 0;
+    for (int i = 0; i < length; i++) {
+        int32_t rectified = filtered[i] < 0 ? -(int32_t)filtered[i] : filtered[i];
+        q15_t env = envelope_update(&envelope, rectified);
+        env_sum += env;
+
+        // Mark/space decision with hysteresis between the thresholds
+        int mark = block_tone && env > (run_mark ? env_off : env_on);
+        if (mark != run_mark) {
+            if (run_us) events_push(0, run_mark, run_us);
+            run_mark = mark;
+            run_us = 0;
         }
-		
-        delay_ms_low_power(1); // Wait for a short time before checking again
+        run_us += US_PER_SAMPLE;
     }
+    events_push(0, run_mark, run_us);
+    run_us = 0;
 
-    return 0;
+    noise_update(&noise, raw_sum / length, (q15_t)(env_sum / length), power, !block_tone);
+    previous_tone = tone;
 }
 
+static int decode_task;
 
-void run_adc_conversion(void) {
-		
-    char sentence[128] = "";
-    int sentence_index = 0;
-    char msg[32];
+#if !EDGE_DETECTION
+static int sample_task;
 
-    adc_init();
-    lcd_init();
-	switches_init();
-    lcd_clear();
-    lcd_set_cursor(0, 0);
+#if ACQUISITION_BURST
+// Collects burst mode samples from the ADC ring into whole blocks.
+static void drain_burst_samples(void) {
+    static uint32_t block[DMA_BUFFER_SIZE];
+    static int fill = 0;
+
+    fill += adc_burst_read(block + fill, DMA_BUFFER_SIZE - fill);
+    if (fill == DMA_BUFFER_SIZE) {
+        on_sample_block(block, fill);
+        fill = 0;
+    }
+}
+#else
+// Block handed over by the DMA interrupt, valid for one block period
+static const uint32_t *volatile ready_block = 0;
+static volatile int ready_length = 0;
+
+static void on_sampler_block(const uint32_t *block, int length) {
+    ready_length = length;
+    ready_block = block;
+    scheduler_post(sample_task);
+}
+#endif
+
+// Sampling task: reduces the samples to mark/space events, outside of
+// the interrupts so that they stay short.
+static void run_sampling(void) {
+#if ACQUISITION_BURST
+    drain_burst_samples();
+#else
+    __disable_irq();
+    const uint32_t *block = ready_block;
+    int length = ready_length;
+    ready_block = 0;
+    __enable_irq();
+
+    if (block) on_sample_block(block, length);
+#endif
+}
+#endif
+
+static void post_decode(void) {
+    scheduler_post(decode_task);
+}
+
+static Decoder decoders[CHANNELS];
+static int shown = 0;
+
+// Decode task: runs whenever the front end has queued events.
+static void run_decode(void) {
+    MorseEvent event;
+    while (events_pop(&event)) {
+        decoder_event(&decoders[event.channel], &event);
+    }
+
+#if EDGE_DETECTION
+    // Wake once per dot while a gap may still end a symbol or word
+    edges_poll_space(decoder_idle(&decoders[0]) ? 0 : speed_unit(&decoders[0].speed));
+#endif
+}
+
+#if !EDGE_DETECTION && IDLE_TIMEOUT_US
+// Idle task: once every decoder has waited for a new message for
+// IDLE_TIMEOUT_US, stops sampling, powers the ADC down and sleeps until a
+// tone or a switch press. The first block after the wake-up reports the
+// latency.
+static void run_idle(void) {
+    static uint32_t last_active = 0;
+    uint32_t now = timebase_now_us();
+
+    for (int k = 0; k < CHANNELS; k++) {
+        if (!decoder_idle(&decoders[k])) last_active = now;
+    }
+    if (now - last_active < IDLE_TIMEOUT_US) return;
+
+#if ACQUISITION_BURST
+    adc_burst_stop();
+#else
+    sampler_stop();
+    ready_block = 0;
+#endif
+    adc_power_down();
+
+    wake_at = idle_sleep();
+
+    // Nothing was timed while asleep, the run starts afresh as silence
+    run_mark = 0;
+    run_us = 0;
+    previous_tone = 0;
+    waking = 1;
+    adc_power_up();
+#if ACQUISITION_BURST
+    adc_burst_start(SAMPLE_RATE);
+#else
+    sampler_start();
+#endif
+    last_active = timebase_now_us();
+}
+#endif
+
+#if UART_OUTPUT
+// Reports for run_uart(), sent ahead of the decoded text, which then
+// resumes on a new line. Text that does not fit in the buffer is cut.
+#define REPORT_SIZE 128
+static char report[REPORT_SIZE];
+static int report_length = 0;
+static int report_sent = 0;
+static int new_line = 0;
+#endif
+
+// Queues @p text to be sent by the UART task.
+static void uart_report(const char *text) {
+#if UART_OUTPUT
+    while (*text && report_length < REPORT_SIZE) {
+        report[report_length++] = *text++;
+    }
+    new_line = 1;
+#else
+    (void)text;
+#endif
+}
+
+// Writes @p value as @p digits decimal digits, zero padded, into @p text.
+static char *format_number(char *text, int value, int digits) {
+    text[digits] = '\0';
+    while (digits-- > 0) {
+        text[digits] = '0' + value % 10;
+        value /= 10;
+    }
+    return text;
+}
+
+// Reports a count of lost data once it has grown since the last report,
+// kept in @p reported. A count that went back down was restarted.
+static void report_loss(const char *what, uint32_t count, uint32_t *reported) {
+    char number[6];
+
+    if (count < *reported) *reported = 0;
+    if (count == *reported) return;
+    *reported = count;
+    uart_report("\r\nLost ");
+    uart_report(format_number(number, count > 99999 ? 99999 : count, 5));
+    uart_report(what);
+}
+
+#if UART_OUTPUT
+// Reports the characters each channel decoded over the last
+// RATE_PERIOD_US, i.e. per minute, as "CPM 500:042 650:030" with
+// MULTI_CHANNEL and "CPM 042" without. Channels that decoded nothing are
+// left out.
+static void report_rates(void) {
+    static uint32_t window_start = 0;
+    static uint32_t counted[CHANNELS];
+    uint32_t now = timebase_now_us();
+    char number[6];
+    int any = 0;
+
+    if (now - window_start < RATE_PERIOD_US) return;
+    window_start = now;
+    for (int k = 0; k < CHANNELS; k++) {
+        uint32_t rate = decoders[k].characters - counted[k];
+        counted[k] = decoders[k].characters;
+        if (rate == 0) continue;
+        uart_report(any ? " " : "\r\nCPM ");
+        any = 1;
+#if MULTI_CHANNEL
+        uart_report(format_number(number, GOERTZEL_F_MIN + k * GOERTZEL_F_STEP, 3));
+        uart_report(":");
+#endif
+        uart_report(format_number(number, rate > 999 ? 999 : rate, 3));
+    }
+}
+#endif
+
+// Draws the last symbol and speed of a channel on the top line and the
+// end of its text on the bottom line into the framebuffer; only the
+// cells that changed reach the display on the next flush.
+static void show_channel(int channel) {
+    const Decoder *dec = &decoders[channel];
+    char elements[MORSE_MAX_ELEMENTS + 1];
+    char number[6];
+    morse_format(dec->last_node, elements);
+
+    lcd_fb_clear_row(0);
+#if MULTI_CHANNEL
+    lcd_fb_print(0, 0, format_number(number, GOERTZEL_F_MIN + channel * GOERTZEL_F_STEP, 3));
+    lcd_fb_print(4, 0, elements);
+#else
+    lcd_fb_print(0, 0, "Word: ");
+    lcd_fb_print(6, 0, elements);
+#endif
+    lcd_fb_print(13, 0, format_number(number, speed_wpm(&dec->speed), 2));
+    lcd_fb_print(15, 0, "w");
+
+    const char *tail = dec->text;
+    if (dec->length > LCD_COLUMNS) {
+        tail = dec->text + (dec->length - LCD_COLUMNS);
+    }
+    lcd_fb_clear_row(1);
+    lcd_fb_print(0, 1, tail);
+
+    if (dec->unknown) {
+        gpio_set(P_LED_R, LED_ON);
+    }
+}
+
+static void clear_text(void) {
+    lcd_fb_clear();
+    for (int k = 0; k < CHANNELS; k++) {
+        decoder_clear(&decoders[k]);
+    }
+}
+
+#if LCD_TIMING
+// Redraws every cell and reports the bytes sent, the time lcd_fb_flush()
+// took and the time until the display had executed the last byte, on the
+// UART and on the top line until the decoder next updates it.
+static void measure_lcd(void) {
+    char number[6];
 
-    wait_for_start_signal();
+    timebase_init();
+    for (int row = 0; row < LCD_ROWS; row++) {
+        lcd_fb_print(0, row, "################");
+    }
+    while (!lcd_queue_idle()) {}
+    uint32_t start = timebase_now_us();
+    int sent = lcd_fb_flush();
+    uint32_t call_us = timebase_now_us() - start;
+    while (!lcd_queue_idle()) {}
+    uint32_t total_us = timebase_now_us() - start;
+
+    format_number(number, total_us > 99999 ? 99999 : total_us, 5);
+    lcd_fb_clear();
+    lcd_fb_print(0, 0, "LCD ");
+    lcd_fb_print(4, 0, number);
+    lcd_fb_print(9, 0, "us");
+    lcd_fb_flush();
+    uart_report("\r\nLCD ");
+    uart_report(format_number(number, sent, 2));
+    uart_report(" bytes ");
+    uart_report(format_number(number, total_us > 99999 ? 99999 : total_us, 5));
+    uart_report("us, call ");
+    uart_report(format_number(number, call_us > 99999 ? 99999 : call_us, 5));
+    uart_report("us");
+}
+#endif
+
+// Display task: reports lost data and character rates, polls the clear
+// switch and sends the changed cells at most every DISPLAY_PERIOD_US,
+// however fast the text changes.
+static void run_display(void) {
+    static uint32_t events_lost = 0;
+    report_loss(" events", events_overruns(), &events_lost);
+#if ACQUISITION_BURST
+    static uint32_t samples_lost = 0;
+    report_loss(" samples", adc_burst_overruns(), &samples_lost);
+#endif
+#if UART_OUTPUT
+    report_rates();
+#endif
+
+    if (switch_get(P_SW_CR)) {
+        clear_text();
+    }
+
+    // Shown until the decoder next updates the top line
+    if (wake_report) {
+        char text[6];
+        format_number(text, wake_latency_us > 99999 ? 99999 : wake_latency_us, 5);
+        wake_report = 0;
+        lcd_fb_clear_row(0);
+        lcd_fb_print(0, 0, "Wake ");
+        lcd_fb_print(5, 0, text);
+        lcd_fb_print(10, 0, "us");
+        uart_report("\r\nWake ");
+        uart_report(text);
+        uart_report("us");
+    }
 
+    // The display stays on a channel while it decodes and moves to
+    // another one once that one has something new
+    int next = decoders[shown].updated ? shown : -1;
+    for (int k = 0; k < CHANNELS; k++) {
+        if (decoders[k].updated) {
+            if (next < 0) next = k;
+            decoders[k].updated = 0;
+        }
+    }
+    if (next >= 0) {
+        shown = next;
+        show_channel(shown);
+    }
+    lcd_fb_flush();
+}
+
+#if UART_OUTPUT
+// UART task: sends pending reports, then the final text of the shown
+// channel, i.e. its completed words. It only fills an empty FIFO, so it
+// never waits on the UART.
+static void run_uart(void) {
+    static int channel = 0;
+    static uint32_t sent = 0;   // Position in the channel's text since decoder_init()
+    const Decoder *dec = &decoders[shown];
+    int room = UART_FIFO_SIZE;
+
+    if (!uart_tx_ready()) return;
+    while (room > 0 && report_sent < report_length) {
+        uart_tx_fifo(report[report_sent++]);
+        room--;
+    }
+    if (report_sent < report_length) return;
+    report_length = 0;
+    report_sent = 0;
+
+    if (channel != shown) {
+        channel = shown;
+        sent = dec->dropped + dec->word_start;
+        new_line = 1;
+    }
+    if ((int32_t)(sent - dec->dropped) < 0) {
+        sent = dec->dropped;    // Dropped before it could be sent
+    }
+    if (new_line && room >= 2) {
+        uart_tx_fifo('\r');
+        uart_tx_fifo('\n');
+        room -= 2;
+        new_line = 0;
+    }
+    while (room-- > 0 && sent < dec->dropped + dec->word_start) {
+        uart_tx_fifo(dec->text[sent - dec->dropped]);
+        sent++;
+    }
+}
+#endif
+
+void run_adc_conversion(void) {
+
+    lcd_init();
+    switches_init();
+    for (int k = 0; k < CHANNELS; k++) {
+        decoder_init(&decoders[k]);
+    }
     lcd_clear();
     gpio_set_mode(P_LED_R, Output);
     gpio_set(P_LED_R, LED_OFF);
-	
-
-
-    int tone_duration = 0;
-    int silence_duration = 0;
-    int is_tone = 0;
-
-    char demod_buffer[128];
-    int demod_index = 0;
-    char current_symbol[16];
-    int current_symbol_index = 0;
-
-    while (1) {
-				if (switch_get(P_SW_CR)) {
-					lcd_clear();
-					sentence_index = 0;
-					sentence[0] = '\0';
-					delay_ms_low_power(2);
-				}
-
-        int averagedSample = calc_movingAverage();
-       
-        int signal_active = (averagedSample > (BASE + THRESHOLD));
-
-        if (signal_active) {
-            tone_duration++;
-            silence_duration = 0;
-            if (!is_tone) is_tone = 1;
-        } else {
-            silence_duration++;
-
-            if (is_tone) {
-                if (tone_duration >= DOT_DURATION && tone_duration < DASH_DURATION) {
-                    if (current_symbol_index < sizeof(current_symbol) - 1)
-                        current_symbol[current_symbol_index++] = '.';
-                } else if (tone_duration >= DASH_DURATION) {
-                    if (current_symbol_index < sizeof(current_symbol) - 1)
-                        current_symbol[current_symbol_index++] = '-';
-                }
-                tone_duration = 0;
-                is_tone = 0;
-            }
-
-            if (silence_duration == SYMBOL_GAP || silence_duration == WORD_GAP) {
-                current_symbol[current_symbol_index] = '\0';
-
-                lcd_set_cursor(0, 0);
-                lcd_print("                ");
-                lcd_set_cursor(0, 0);
-                sprintf(msg, "Word: %s", current_symbol);
-                lcd_print(msg);
-
-                if (current_symbol[0] != '\0') {
-                    char translated = morse_to_char(current_symbol);
-
-                    if (translated == '#') {
-                        gpio_set(P_LED_R, LED_ON);
-											#
-										}
-						
-										if (sentence_index < sizeof(sentence) - 1) {
-                            sentence[sentence_index++] = translated;
-                            sentence[sentence_index] = '\0';
-                    }
-
-                    current_symbol_index = 0;
-                    current_symbol[0] = '\0';
-
-                } else if (silence_duration == WORD_GAP) {
-                    if (sentence_index < sizeof(sentence) - 1) {
-                        sentence[sentence_index++] = ' ';
-                        sentence[sentence_index] = '\0';
-                    }
-                }
-
-                int len = strlen(sentence);
-                const char* display_ptr = sentence;
-                if (len > 16) {
-                    display_ptr = sentence + (len - 16);
-                }
-                lcd_set_cursor(0, 1);
-                lcd_print(display_ptr);
-
-                int len_sym = strlen(current_symbol);
-                if (demod_index + len_sym < sizeof(demod_buffer) - 2) {
-                    for (int i = 0; i < len_sym; i++) {
-                        demod_buffer[demod_index++] = current_symbol[i];
-                    }
-                    demod_buffer[demod_index++] = (silence_duration == WORD_GAP) ? '/' : ' ';
-                    demod_buffer[demod_index] = '\0';
-                }
-
-                current_symbol_index = 0;
-            }
-						else if (silence_duration >= 2*WORD_GAP) {
-									//break;
-                                    bool if_again = true;
-						}
-        } 
-
-        if (demod_index < sizeof(demod_buffer)) {
-            demod_buffer[demod_index] = '\0';
-        }
-				delay_ms_low_power(14);
-                if(if_again) {
-                    wait_for_start_signal();
-                }
-                if_again = false;
+#if UART_OUTPUT
+    uart_init(UART_BAUD);
+    uart_enable();
+#endif
+#if LCD_TIMING
+    measure_lcd();
+#endif
+
+    // Highest priority first. The front end times marks and spaces in
+    // its own clock, so however late a task runs the durations stay exact.
+#if !EDGE_DETECTION
+    sample_task = scheduler_add(run_sampling, ACQUISITION_BURST ? BURST_DRAIN_US : 0);
+#endif
+    decode_task = scheduler_add(run_decode, 0);
+    scheduler_add(run_display, DISPLAY_PERIOD_US);
+#if !EDGE_DETECTION && IDLE_TIMEOUT_US
+    idle_init();
+    scheduler_add(run_idle, IDLE_CHECK_US);
+#endif
+#if UART_OUTPUT
+    scheduler_add(run_uart, UART_PERIOD_US);
+#endif
+    events_set_notify(post_decode);
+
+#if EDGE_DETECTION
+    // Comparator edges alone, the ADC stays off
+    edges_init();
+    edges_start();
+#else
+    noise_init(&noise);
+#if MULTI_CHANNEL
+    for (int k = 0; k < CHANNELS; k++) {
+        noise_init(&channel_noise[k]);
     }
-}
\ No newline at end of file
+#endif
+    goertzel_bank_init(&tone_bank);
+    bandpass_init(&prefilter, BANDPASS_WIDE);
+    envelope_init(&envelope);
+#if FREQ_METER
+    freqmeter_init();
+#endif
+#if ACQUISITION_BURST
+    adc_init();
+    adc_burst_start(SAMPLE_RATE);
+#else
+    sampler_init(SAMPLE_RATE);
+    sampler_set_callback(on_sampler_block);
+    sampler_start();
+#endif
+#endif
+
+    scheduler_run();
+}
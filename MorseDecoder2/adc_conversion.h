@@ -4,10 +4,17 @@
 /**
  * @brief Runs the ADC conversion routine.
  *
- * Initializes the ADC, LCD, and feedback LED.
- * Then continuously reads the analog signal from pin 15 (P_ADC),
- * blinks the LED to signal a conversion event, scales the ADC reading to a voltage,
- * and displays the ADC value and voltage on the LCD.
+ * Initializes the LCD, switches and the timer/DMA sampler on P_ADC.
+ * Each DMA block is reduced to one rectified level, which drives the
+ * Morse timing state machine; decoded text is shown on the LCD.
+ * With EDGE_DETECTION set the ADC is not used and the timing runs on
+ * CMP1 edge timestamps instead, the input going to P_CMP_PLUS.
+ *
+ * Sampling, decoding, display and UART output run as separate tasks of
+ * the scheduler (see scheduler.h), each at its own rate, and the CPU
+ * sleeps whenever none of them has work. After IDLE_TIMEOUT_US without
+ * a message the ADC is powered down until a CMP1 edge or a press of
+ * P_SW (see idle.h), and the wake-up latency is shown and sent.
  */
 void run_adc_conversion(void);
 
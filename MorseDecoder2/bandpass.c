@@ -0,0 +1,50 @@
+#include "bandpass.h"
+
+// Coefficients are stored halved, arm_biquad_cascade_df1_q15 shifts back
+#define BANDPASS_POST_SHIFT 1
+
+// Constant peak gain band-pass biquads at 8 kHz, Q15 {b0, 0, b1, b2, -a1, -a2} / 2.
+// Rows follow the goertzel_coeff bins with a 150 Hz bandwidth; the last row
+// covers the whole 300-800 Hz band (490 Hz centre, 500 Hz wide).
+static const q15_t bandpass_coeff[GOERTZEL_BINS + 1][6] = {
+    { 903, 0, 0,  -903, 30106, -14577 },  // 300 Hz
+    { 901, 0, 0,  -901, 29804, -14583 },  // 350 Hz
+    { 897, 0, 0,  -897, 29457, -14589 },  // 400 Hz
+    { 894, 0, 0,  -894, 29066, -14597 },  // 450 Hz
+    { 889, 0, 0,  -889, 28630, -14605 },  // 500 Hz
+    { 885, 0, 0,  -885, 28151, -14614 },  // 550 Hz
+    { 880, 0, 0,  -880, 27629, -14624 },  // 600 Hz
+    { 874, 0, 0,  -874, 27064, -14635 },  // 650 Hz
+    { 869, 0, 0,  -869, 26458, -14647 },  // 700 Hz
+    { 862, 0, 0,  -862, 25812, -14659 },  // 750 Hz
+    { 856, 0, 0,  -856, 25125, -14673 },  // 800 Hz
+    { 2634, 0, 0, -2634, 25490, -11117 }, // 300-800 Hz
+};
+
+// Fills the cascade with the selected row repeated for every stage
+static void load_coefficients(BandPass *bp, int bin) {
+    const q15_t *row = bandpass_coeff[bin == BANDPASS_WIDE ? GOERTZEL_BINS : bin];
+    for (int s = 0; s < BANDPASS_STAGES; s++) {
+        for (int i = 0; i < 6; i++) {
+            bp->coeff[6 * s + i] = row[i];
+        }
+    }
+}
+
+void bandpass_init(BandPass *bp, int bin) {
+    bp->bin = bin;
+    load_coefficients(bp, bin);
+    arm_biquad_cascade_df1_init_q15(&bp->biquad, BANDPASS_STAGES, bp->coeff,
+                                    bp->state, BANDPASS_POST_SHIFT);
+}
+
+void bandpass_tune(BandPass *bp, int bin) {
+    if (bin == bp->bin) return;
+    bp->bin = bin;
+    // The instance points at bp->coeff, so rewriting it retunes in place
+    load_coefficients(bp, bin);
+}
+
+void bandpass_process(BandPass *bp, const q15_t *in, q15_t *out, int n) {
+    arm_biquad_cascade_df1_q15(&bp->biquad, in, out, n);
+}
@@ -0,0 +1,41 @@
+#ifndef BANDPASS_H
+#define BANDPASS_H
+
+#include <stdint.h>
+#include "arm_math.h"       // CMSIS-DSP biquad cascade
+#include "goertzel.h"       // GOERTZEL_BINS
+
+#define BANDPASS_STAGES 2   // Identical biquads in cascade
+#define BANDPASS_WIDE   (-1) // 300-800 Hz, used until a tone is locked
+
+/** Band-pass pre-filter centred on one Goertzel bin. */
+typedef struct {
+    arm_biquad_casd_df1_inst_q15 biquad;
+    q15_t coeff[6 * BANDPASS_STAGES];
+    q15_t state[4 * BANDPASS_STAGES];
+    int bin;
+} BandPass;
+
+/**
+ * @brief Sets up the filter with cleared state.
+ * @param bp  Filter state.
+ * @param bin Goertzel bin to centre on (150 Hz wide), or BANDPASS_WIDE.
+ */
+void bandpass_init(BandPass *bp, int bin);
+
+/**
+ * @brief Moves the pass band to another bin, keeping the delay line
+ *        so the output does not jump. Does nothing if already there.
+ */
+void bandpass_tune(BandPass *bp, int bin);
+
+/**
+ * @brief Filters one block of samples with arm_biquad_cascade_df1_q15().
+ * @param bp  Filter state.
+ * @param in  Q15 samples with the DC offset removed.
+ * @param out Q15 filtered samples, may not alias @p in.
+ * @param n   Number of samples.
+ */
+void bandpass_process(BandPass *bp, const q15_t *in, q15_t *out, int n);
+
+#endif // BANDPASS_H
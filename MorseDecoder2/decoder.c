@@ -0,0 +1,142 @@
+#include <string.h>
+#include "morse.h"
+#include "decoder.h"
+
+#if DECODER_SOFT_DECISION && SOFT_MAX_MARKS > DECODER_TEXT_SIZE - 1
+#error "A word of SOFT_MAX_MARKS characters must fit in the text"
+#endif
+
+// Makes room for the text to reach @p end, dropping the oldest half of it
+// or more if that is not enough. Only final text is dropped, so the word
+// in progress stays whole and dropped counts exactly what left text.
+static void make_room(Decoder *dec, int end) {
+    int drop = DECODER_TEXT_SIZE / 2;
+
+    if (end <= DECODER_TEXT_SIZE - 1) return;
+    if (drop < end - (DECODER_TEXT_SIZE - 1)) drop = end - (DECODER_TEXT_SIZE - 1);
+    if (drop > dec->word_start) drop = dec->word_start;
+    memmove(dec->text, dec->text + drop, dec->length - drop + 1);
+    dec->length -= drop;
+    dec->dropped += drop;
+    dec->word_start -= drop;
+}
+
+// Closes the symbol in progress once a letter or word gap has elapsed.
+static void end_symbol(Decoder *dec, int word_gap) {
+    if (dec->symbol_node != MORSE_ROOT) {
+        dec->characters++;
+#if DECODER_SOFT_DECISION
+        // Every mark may read as a character of its own
+        make_room(dec, dec->word_start + dec->word.marks);
+        // The whole word is searched again, as a new character can
+        // change the most likely reading of the earlier ones
+        dec->length = dec->word_start + soft_decode(&dec->word, &dec->speed,
+                                                    dec->text + dec->word_start,
+                                                    DECODER_TEXT_SIZE - 1 - dec->word_start);
+#else
+        make_room(dec, dec->length + 1);
+        char translated = morse_char(dec->symbol_node);
+        if (translated == '#') dec->unknown++;
+        dec->text[dec->length++] = translated;
+        // Thresholded characters are never read again, so a word too long
+        // to keep whole is made final before make_room() has to drop it
+        if (dec->length - dec->word_start >= DECODER_TEXT_SIZE / 2) dec->word_start = dec->length;
+#endif
+        dec->text[dec->length] = '\0';
+
+    } else if (word_gap) {
+        dec->word_start = dec->length;
+        make_room(dec, dec->length + 1);
+        dec->text[dec->length++] = ' ';
+        dec->text[dec->length] = '\0';
+        dec->word_start = dec->length;
+        soft_init(&dec->word);
+    }
+
+    dec->last_node = dec->symbol_node;
+    dec->symbol_node = MORSE_ROOT;
+    dec->updated = 1;
+}
+
+// Runs the timing state machine over @p length_us of all tone or all
+// silence. Elements and gaps are classified against the adaptive speed
+// estimate, which every completed mark and space updates.
+// Returns 1 once the line has been silent long enough to wait for a new start.
+static int decode_run(Decoder *dec, int signal_active, int32_t length_us) {
+    if (length_us <= 0) return 0;
+
+    if (signal_active) {
+        if (!dec->is_tone) {
+            if (dec->silence_duration > 0) {
+                speed_space(&dec->speed, dec->silence_duration);
+                soft_space(&dec->word, dec->silence_duration);
+            }
+            dec->is_tone = 1;
+        }
+        dec->tone_duration += length_us;
+        dec->silence_duration = 0;
+        return 0;
+    }
+
+    if (dec->is_tone) {
+        int dash = speed_mark(&dec->speed, dec->tone_duration);
+        if (dash != SPEED_GLITCH) {
+            dec->symbol_node = morse_step(dec->symbol_node, dash);
+            soft_mark(&dec->word, dec->tone_duration);
+        }
+        dec->tone_duration = 0;
+        dec->is_tone = 0;
+    }
+
+    int32_t letter_gap = speed_letter_gap(&dec->speed);
+    int32_t word_gap = speed_word_gap(&dec->speed);
+    int32_t previous = dec->silence_duration;
+    dec->silence_duration += length_us;
+
+    if (previous < letter_gap && dec->silence_duration >= letter_gap) end_symbol(dec, 0);
+    if (previous < word_gap && dec->silence_duration >= word_gap) end_symbol(dec, 1);
+
+    return dec->silence_duration >= 2 * word_gap;
+}
+
+void decoder_init(Decoder *dec) {
+    speed_init(&dec->speed);
+    soft_init(&dec->word);
+    dec->tone_duration = 0;
+    dec->silence_duration = 0;
+    dec->is_tone = 0;
+    dec->waiting = 1;
+    dec->symbol_node = MORSE_ROOT;
+    dec->last_node = MORSE_ROOT;
+    dec->characters = 0;
+    dec->unknown = 0;
+    dec->dropped = 0;
+    dec->word_start = 0;
+    decoder_clear(dec);
+}
+
+void decoder_clear(Decoder *dec) {
+    dec->dropped += dec->word_start;
+    dec->text[0] = '\0';
+    dec->length = 0;
+    dec->word_start = 0;
+    soft_init(&dec->word);
+    dec->updated = 1;
+}
+
+void decoder_event(Decoder *dec, const MorseEvent *event) {
+    if (event->mark) {
+        dec->waiting = 0;
+    } else if (dec->waiting) {
+        return;
+    }
+
+    if (decode_run(dec, event->mark, event->duration_us)) {
+        dec->waiting = 1;
+        dec->silence_duration = 0;
+    }
+}
+
+int decoder_idle(const Decoder *dec) {
+    return dec->waiting;
+}
@@ -0,0 +1,54 @@
+#ifndef DECODER_H
+#define DECODER_H
+
+#include <stdint.h>
+#include "speed.h"          // SpeedTracker
+#include "soft.h"           // SoftWord
+#include "events.h"         // MorseEvent
+
+#ifndef DECODER_SOFT_DECISION
+#define DECODER_SOFT_DECISION 1 // 1: decode each word by likelihood search, 0: per-element thresholds
+#endif
+#define DECODER_TEXT_SIZE     64 // Decoded text kept, the oldest final half is dropped when full
+
+/**
+ * Morse timing state machine and decoded text of one signal. All state
+ * lives in the object, so any number of signals can be decoded side by
+ * side, each fed with its own mark/space events.
+ */
+typedef struct {
+    SpeedTracker speed;
+    SoftWord word;                  // Timing of the word in progress
+    int32_t tone_duration;          // Microseconds
+    int32_t silence_duration;
+    int is_tone;
+    int waiting;                    // Ignoring silence until the next mark
+    int symbol_node;                // Symbol in progress, see morse.h
+
+    char text[DECODER_TEXT_SIZE];   // Decoded text, '\0' terminated
+    int length;
+    int word_start;                 // Where the word in progress starts in text, the text before it is final
+    uint32_t dropped;               // Characters dropped from the front of text since decoder_init()
+    int last_node;                  // Symbol closed by the last gap, MORSE_ROOT after a word gap
+    uint32_t characters;            // Characters decoded since decoder_init()
+    uint32_t unknown;               // Of which had no character ('#'), threshold decoding only
+    int updated;                    // Set on every change of text or last_node
+} Decoder;
+
+/** @brief Starts with no text, nominal speed and waiting for a first mark. */
+void decoder_init(Decoder *dec);
+
+/** @brief Empties the text, keeping the speed estimate. */
+void decoder_clear(Decoder *dec);
+
+/**
+ * @brief Consumes one event of the decoder's signal. Silence before the
+ *        first mark, and after a silence long enough to end the message,
+ *        is ignored until the next mark starts a new one.
+ */
+void decoder_event(Decoder *dec, const MorseEvent *event);
+
+/** @brief Non-zero while the decoder waits for a new message. */
+int decoder_idle(const Decoder *dec);
+
+#endif // DECODER_H
@@ -13,10 +13,37 @@
 #define ADC_PDN                  ((uint32_t)((1)<<21)) 
 #define ADC_START                ((uint32_t)((1)<<24)) 
 #define ADC_PORT_SELECT(n)        ((uint32_t)((1)<<n))
+#define ADC_CLKDIV_MASK          ((uint32_t)((0xFF)<<8))
+#define ADC_BURST                ((uint32_t)((1)<<16))
+#define ADC_START_MASK           ((uint32_t)((7)<<24))
+#define ADC_START_ON_MAT0_1      ((uint32_t)((4)<<24)) //Rising edge of TIMER0 MAT0.1
+
+//INTEN
+#define ADC_GLOBAL_INTEN         ((uint32_t)((1)<<8))
+
+//DR
+#define ADC_DONE                 ((uint32_t)(1UL<<31))
+
+//Burst mode sample ring, power of two
+#define ADC_RING_SIZE            (512)
+#define ADC_RING_MASK            (ADC_RING_SIZE - 1)
 
 #define ADC_SAMPLING_FREQUENCY       (400000)                 //400kHz
 #define ADC_VREF                     (3.3)
 
+//Converts a conversion rate into the CR CLKDIV field (31 clocks per conversion)
+#define ADC_CLKDIV(rate)             ((PeripheralClock * 2 + (rate) * 31) / (2 * (rate) * 31) - 1)
+
+//ADC0 channel of P_ADC, resolved once in adc_init()
+static uint8_t adc_channel;
+
+//Single producer (ADC_IRQHandler) / single consumer (adc_burst_read) ring.
+//Each side only writes its own index, so no locking is needed.
+static uint32_t adc_ring[ADC_RING_SIZE];
+static volatile uint32_t adc_ring_head = 0;
+static volatile uint32_t adc_ring_tail = 0;
+static volatile uint32_t adc_ring_overruns = 0;
+
 uint8_t GET_ADC0_Port(Pin pin){
 	
 	uint8_t ADC0_Pin_num;
@@ -39,32 +66,140 @@ void adc_init(void) {
 	*ADC0_Port &= ~IOCON_DIGITAL_MODE;
 	
 	LPC_ADC -> CR = 0;
+	adc_channel = GET_ADC0_Port(P_ADC);
 	
 	//Define APB clock
-	temp = ADC_SAMPLING_FREQUENCY * 31;
-	temp = (PeripheralClock * 2 + temp) / (2 * temp) - 1;
+	temp = ADC_CLKDIV(ADC_SAMPLING_FREQUENCY);
 	LPC_ADC -> CR |=  (temp<<8);
 	
-	LPC_ADC -> CR |= ADC_PORT_SELECT(GET_ADC0_Port(P_ADC)) | ADC_PDN; // ADC pre-setting
+	LPC_ADC -> CR |= ADC_PORT_SELECT(adc_channel) | ADC_PDN; // ADC pre-setting
+
+}
+
+void adc_power_down(void) {
+
+	LPC_ADC -> CR &= ~ADC_PDN;
+	LPC_SC -> PCONP &= ~ADC_POWER_EN;
+
+}
+
+void adc_power_up(void) {
+
+	LPC_SC -> PCONP |= ADC_POWER_EN;
+	LPC_ADC -> CR |= ADC_PDN;
+
+}
+
+void adc_enable_dma_trigger(void) {
+
+	//The DMA request follows the channel interrupt flag, so the channel interrupt
+	//is enabled here while the NVIC line stays off
+	NVIC_DisableIRQ(ADC_IRQn);
+	LPC_ADC -> INTEN = (1UL << adc_channel);
+
+	LPC_ADC -> CR = (LPC_ADC -> CR & ~ADC_START_MASK) | ADC_START_ON_MAT0_1;
+
+}
+
+void adc_disable_trigger(void) {
+
+	LPC_ADC -> CR &= ~ADC_START_MASK;
+	LPC_ADC -> INTEN = ADC_GLOBAL_INTEN; //Reset value
+
+}
+
+unsigned int adc_data_address(void) {
+
+	return (unsigned int)&LPC_ADC->DR[adc_channel];
+
+}
+
+void adc_burst_start(uint32_t rate) {
+
+	uint32_t temp = ADC_CLKDIV(rate);
+	if (temp > 0xFF) temp = 0xFF;
+
+	adc_ring_head = 0;
+	adc_ring_tail = 0;
+	adc_ring_overruns = 0;
+
+	//START must be 0 while BURST is set
+	LPC_ADC -> CR &= ~(ADC_START_MASK | ADC_CLKDIV_MASK);
+	LPC_ADC -> CR |= (temp<<8);
+
+	LPC_ADC -> INTEN = (1UL << adc_channel);
+	NVIC_SetPriority(ADC_IRQn, 1);
+	NVIC_ClearPendingIRQ(ADC_IRQn);
+	NVIC_EnableIRQ(ADC_IRQn);
+	__enable_irq();
+
+	LPC_ADC -> CR |= ADC_BURST;
+
+}
+
+void adc_burst_stop(void) {
+
+	LPC_ADC -> CR &= ~ADC_BURST;
+	NVIC_DisableIRQ(ADC_IRQn);
+	LPC_ADC -> INTEN = ADC_GLOBAL_INTEN; //Reset value
+
+	//Back to the single conversion clock
+	LPC_ADC -> CR = (LPC_ADC -> CR & ~ADC_CLKDIV_MASK) | (ADC_CLKDIV(ADC_SAMPLING_FREQUENCY)<<8);
+
+}
+
+int adc_burst_read(uint32_t *dst, int max) {
+
+	uint32_t tail = adc_ring_tail;
+	uint32_t avail = adc_ring_head - tail;
+	int n;
+
+	if (avail > (uint32_t)max) avail = max;
+	for (n = 0; n < avail; n++) {
+		dst[n] = adc_ring[(tail + n) & ADC_RING_MASK];
+	}
+
+	//Hand the slots back to the ISR only after they have been copied
+	__DMB();
+	adc_ring_tail = tail + avail;
+
+	return avail;
+
+}
+
+uint32_t adc_burst_overruns(void) {
+
+	return adc_ring_overruns;
+
+}
+
+void ADC_IRQHandler(void) {
+
+	//Reading the data register clears DONE and the interrupt
+	uint32_t data = LPC_ADC->DR[adc_channel];
+	uint32_t head = adc_ring_head;
+
+	if (head - adc_ring_tail < ADC_RING_SIZE) {
+		adc_ring[head & ADC_RING_MASK] = data;
+		__DMB();
+		adc_ring_head = head + 1;
+	}
+	else {
+		adc_ring_overruns++;
+	}
 
 }
 
-//#define BASE  2000		//Ignacys change
 int adc_read(void) {
 	
 	uint32_t data;
 	
 	LPC_ADC -> CR |= ADC_START; //Start conversion
 	
-	while( !(LPC_ADC->DR[GET_ADC0_Port(P_ADC)] & (1UL<<31)) );//wait until the conversion completes
+	while( !((data = LPC_ADC->DR[adc_channel]) & ADC_DONE) );//wait until the conversion completes
 	LPC_ADC -> CR &= ~ADC_START;
 	
-	data = ((LPC_ADC->DR[GET_ADC0_Port(P_ADC)] >> 4) ) & 0xFFF;
-//	return data;
-	if (data < BASE)
-        return BASE-data + BASE;
-    else
-        return data;
+	return ADC_RESULT(data);
 
 }
 
@@ -5,16 +5,68 @@
  */
 #ifndef ADC_H
 #define ADC_H
-#define BASE  2000
+#include <stdint.h>
+
+/*! Extracts the 12-bit result from a raw ADC data register value. */
+#define ADC_RESULT(dr)  (((dr) >> 4) & 0xFFF)
 
 /*! \brief Initializes the analogue to digital converter, and configures
  *         the appropriate GPIO pin.
  */
 void adc_init(void);
 
+/*! \brief Switches the converter and its clock off. Conversions must be
+ *         stopped first.
+ */
+void adc_power_down(void);
+
+/*! \brief Powers the converter up again after adc_power_down(), keeping
+ *         the configuration from before.
+ */
+void adc_power_up(void);
+
 /*! \brief Reads the current value of the ADC.
  *  \return Potential of the pin, relative to ground.
  */
 int adc_read(void);
 
+/*! \brief Starts a conversion on every rising edge of TIMER0 MAT0.1 and
+ *         raises a DMA request (\a DMA_REQ_ADC) as each one completes.
+ *  \sa adc_data_address for the DMA source.
+ */
+void adc_enable_dma_trigger(void);
+
+/*! \brief Stops hardware triggered conversions. */
+void adc_disable_trigger(void);
+
+/*! \brief Address of the data register of the ADC input pin.
+ *  \return Register address, suitable as a DMA source.
+ */
+unsigned int adc_data_address(void);
+
+/*! \brief Starts continuous conversions using the ADC burst mode.
+ *
+ *  Every completed conversion raises the ADC interrupt, which stores the
+ *  raw data register value in a lock-free ring for adc_burst_read().
+ *
+ *  \param rate  Conversions per second. Rates below PCLK / (256 * 31) are
+ *               clamped to that value.
+ */
+void adc_burst_start(uint32_t rate);
+
+/*! \brief Stops burst mode conversions. */
+void adc_burst_stop(void);
+
+/*! \brief Drains samples collected in burst mode.
+ *  \param dst  Destination for raw data register values (see ADC_RESULT()).
+ *  \param max  Maximum number of samples to copy.
+ *  \return     Number of samples copied.
+ */
+int adc_burst_read(uint32_t *dst, int max);
+
+/*! \brief Number of samples dropped because the ring was full.
+ *  \return Overrun count since adc_burst_start().
+ */
+uint32_t adc_burst_overruns(void);
+
 #endif // ADC_H
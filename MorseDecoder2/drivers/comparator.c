@@ -55,6 +55,9 @@ void comparator_set_callback(void (*callback)(int state)) {
 	
 	CMP_callback = callback; 
 	
+	//Drop an edge latched while the interrupt was off
+	LPC_COMPARATOR->CTRL1 |= (0x1 << 19);
+	
 	NVIC_SetPriority(CMP1_IRQn, 3);
 	NVIC_ClearPendingIRQ(CMP1_IRQn);
 	NVIC_EnableIRQ(CMP1_IRQn);
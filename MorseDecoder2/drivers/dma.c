@@ -0,0 +1,215 @@
+#include <platform.h>
+#include <dma.h>
+
+//PCONP power control register
+#define PCGPDMA                  ((uint32_t)(1UL<<29))
+
+//DMACConfig register
+#define DMA_CONTROLLER_EN        ((uint32_t)(1<<0))
+
+//DMACCxControl register
+#define DMA_CTRL_SIZE(n)         ((uint32_t)((n) & 0xFFF))
+#define DMA_CTRL_SBSIZE(n)       ((uint32_t)(((n) & 0x7)<<12))
+#define DMA_CTRL_DBSIZE(n)       ((uint32_t)(((n) & 0x7)<<15))
+#define DMA_CTRL_SWIDTH(n)       ((uint32_t)(((n) & 0x7)<<18))
+#define DMA_CTRL_DWIDTH(n)       ((uint32_t)(((n) & 0x7)<<21))
+#define DMA_CTRL_SI              ((uint32_t)(1UL<<26))  //Source increment
+#define DMA_CTRL_DI              ((uint32_t)(1UL<<27))  //Destination increment
+#define DMA_CTRL_I               ((uint32_t)(1UL<<31))  //Terminal count interrupt enable
+
+//DMACCxConfig register
+#define DMA_CFG_EN               ((uint32_t)(1<<0))
+#define DMA_CFG_SRC_PERIPH(n)    ((uint32_t)(((n) & 0x1F)<<1))
+#define DMA_CFG_DST_PERIPH(n)    ((uint32_t)(((n) & 0x1F)<<6))
+#define DMA_CFG_FLOW(n)          ((uint32_t)(((n) & 0x7)<<11))
+#define DMA_CFG_IE               ((uint32_t)(1<<14))    //Error interrupt mask
+#define DMA_CFG_ITC              ((uint32_t)(1<<15))    //Terminal count interrupt mask
+
+#define DMA_CHANNELS             8
+
+//Select DMA channel
+#define GET_DMA_CHANNEL(n)       ((LPC_GPDMACH_TypeDef*) (LPC_GPDMACH0_BASE + 0x20 * (n)))
+
+static void (*DMA_callback)(void);
+static void (*DMA_channel_callback[DMA_CHANNELS])(void);
+static int DMA_initialised = 0;
+
+void dma_init(void) {
+
+	uint32_t i;
+
+	if (DMA_initialised) return;
+	DMA_initialised = 1;
+
+	LPC_SC->PCONP |= PCGPDMA;   //Enable power output for GPDMA
+
+	//Disable all channels and clear pending requests
+	for (i = 0; i < DMA_CHANNELS; i++) {
+		GET_DMA_CHANNEL(i)->CConfig = 0;
+	}
+	LPC_GPDMA->IntTCClear = 0xFF;
+	LPC_GPDMA->IntErrClr = 0xFF;
+
+	LPC_GPDMA->Config = DMA_CONTROLLER_EN;  //Little-endian, controller enabled
+	while (!(LPC_GPDMA->Config & DMA_CONTROLLER_EN));
+
+}
+
+unsigned int dma_control(unsigned int TransferSize,
+												 unsigned int BurstSize,
+												 unsigned int TransferWidth,
+												 unsigned int TransferType) {
+
+	unsigned int control = DMA_CTRL_SIZE(TransferSize)
+											 | DMA_CTRL_SBSIZE(BurstSize) | DMA_CTRL_DBSIZE(BurstSize)
+											 | DMA_CTRL_SWIDTH(TransferWidth) | DMA_CTRL_DWIDTH(TransferWidth)
+											 | DMA_CTRL_I;
+
+	//Only the memory side of a transfer walks through its buffer
+	switch (TransferType & 0x3) {
+		case DMA_M2M:
+			control |= DMA_CTRL_SI | DMA_CTRL_DI;
+			break;
+		case DMA_M2P:
+			control |= DMA_CTRL_SI;
+			break;
+		case DMA_P2M:
+			control |= DMA_CTRL_DI;
+			break;
+		default:
+			break;
+	}
+	if (TransferType & DMA_SRC_FIXED) control &= ~DMA_CTRL_SI;
+	if (TransferType & DMA_NO_IRQ) control &= ~DMA_CTRL_I;
+
+	return control;
+}
+
+//Request lines are shared with timer matches, DMAREQSEL picks one
+static void dma_select_request(unsigned int Periph) {
+
+	unsigned int line = Periph & 0x1F;
+
+	if (Periph == DMA_REQ_NONE) return;
+	if (Periph & DMA_REQ_TIMER) {
+		LPC_SC->DMAREQSEL |= (1UL << line);
+	}
+	else {
+		LPC_SC->DMAREQSEL &= ~(1UL << line);
+	}
+
+}
+
+void dma_setup(char ChannelNum,
+							 unsigned int SrcMemAddr,
+							 unsigned int DstMemAddr,
+							 unsigned int SrcPeriph,
+							 unsigned int DstPeriph,
+							 unsigned int TransferSize,
+							 unsigned int BurstSize,
+							 unsigned int TransferWidth,
+							 unsigned int TransferType,
+							 unsigned int Dmalli  ) {
+
+	LPC_GPDMACH_TypeDef* ch = GET_DMA_CHANNEL(ChannelNum);
+
+	ch->CConfig = 0;  //Channel must be disabled while it is programmed
+	dma_select_request(SrcPeriph);
+	dma_select_request(DstPeriph);
+
+	LPC_GPDMA->IntTCClear = (1UL << ChannelNum);
+	LPC_GPDMA->IntErrClr = (1UL << ChannelNum);
+
+	ch->CSrcAddr = SrcMemAddr;
+	ch->CDestAddr = DstMemAddr;
+	ch->CLLI = Dmalli & ~0x3;
+	ch->CControl = dma_control(TransferSize, BurstSize, TransferWidth, TransferType);
+	ch->CConfig = DMA_CFG_SRC_PERIPH(SrcPeriph) | DMA_CFG_DST_PERIPH(DstPeriph)
+							| DMA_CFG_FLOW(TransferType) | DMA_CFG_IE | DMA_CFG_ITC;
+
+}
+
+void dma_enable(unsigned char ChannelNum) {
+
+	GET_DMA_CHANNEL(ChannelNum)->CConfig |= DMA_CFG_EN;
+
+}
+
+void dma_disable(unsigned char ChannelNum) {
+
+	GET_DMA_CHANNEL(ChannelNum)->CConfig &= ~DMA_CFG_EN;
+
+}
+
+unsigned int dma_state(unsigned char ChannelNum) {
+
+	return (LPC_GPDMA->IntTCStat >> ChannelNum) & 0x1;
+
+}
+
+void dma_clean(unsigned char ChannelNum) {
+
+	LPC_GPDMA->IntTCClear = (1UL << ChannelNum);
+	LPC_GPDMA->IntErrClr = (1UL << ChannelNum);
+
+}
+
+void dma_src_memory(unsigned char ChannelNum, unsigned int address) {
+
+	GET_DMA_CHANNEL(ChannelNum)->CSrcAddr = address;
+
+}
+
+void dma_dest_memory(unsigned char ChannelNum, unsigned int address) {
+
+	GET_DMA_CHANNEL(ChannelNum)->CDestAddr = address;
+
+}
+
+void dma_transfersize(unsigned char ChannelNum, unsigned int size) {
+
+	LPC_GPDMACH_TypeDef* ch = GET_DMA_CHANNEL(ChannelNum);
+	ch->CControl = (ch->CControl & ~0xFFF) | DMA_CTRL_SIZE(size);
+
+}
+
+void dma_set_callback(void (*callback)(void)) {
+
+	DMA_callback = callback;
+
+	NVIC_SetPriority(DMA_IRQn, 2);
+	NVIC_ClearPendingIRQ(DMA_IRQn);
+	NVIC_EnableIRQ(DMA_IRQn);
+	__enable_irq();
+
+}
+
+void dma_set_channel_callback(unsigned char ChannelNum, void (*callback)(void)) {
+
+	DMA_channel_callback[ChannelNum] = callback;
+
+	NVIC_SetPriority(DMA_IRQn, 2);
+	NVIC_EnableIRQ(DMA_IRQn);
+
+}
+
+void DMA_IRQHandler(void) {
+
+	uint32_t i;
+
+	for (i = 0; i < DMA_CHANNELS; i++) {
+		if (DMA_channel_callback[i] && dma_state(i)) {
+			dma_clean(i);
+			DMA_channel_callback[i]();
+		}
+	}
+
+	//The callback checks dma_state() for its own channels and clears them
+	if (DMA_callback) DMA_callback();
+
+	//Error interrupts are not recoverable here, just acknowledge them
+	LPC_GPDMA->IntErrClr = LPC_GPDMA->IntErrStat;
+
+}
+
+// *******************************ARM University Program Copyright © ARM Ltd 2014*************************************
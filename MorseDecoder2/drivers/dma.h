@@ -12,8 +12,46 @@
 #define PONG 0x01
 #define DMA_BUFFER_SIZE 128  
 
+/* TransferType: flow control of a channel */
+#define DMA_M2M 0x00   //!< Memory to memory.
+#define DMA_M2P 0x01   //!< Memory to peripheral.
+#define DMA_P2M 0x02   //!< Peripheral to memory.
+#define DMA_P2P 0x03   //!< Peripheral to peripheral.
 
-/*! \brief Initialises the DMA pheriperal module 
+/* TransferType modifiers, OR-ed into the type */
+#define DMA_SRC_FIXED  0x10   //!< Repeats one source word instead of walking a buffer.
+#define DMA_NO_IRQ     0x20   //!< No terminal count interrupt when the item completes.
+
+/* TransferWidth */
+#define DMA_WIDTH_BYTE 0x00
+#define DMA_WIDTH_HALF 0x01
+#define DMA_WIDTH_WORD 0x02
+
+/* BurstSize */
+#define DMA_BURST_1    0x00
+#define DMA_BURST_4    0x01
+#define DMA_BURST_8    0x02
+
+/* Peripheral request lines (SrcPeriph / DstPeriph) */
+#define DMA_REQ_NONE   0
+#define DMA_REQ_ADC    8
+#define DMA_REQ_TIMER  0x20   //!< Flags the timer match alternative of a line (DMAREQSEL).
+#define DMA_REQ_T2_MAT0 (DMA_REQ_TIMER | 4)  //!< Shares line 4 with SSP1 Tx.
+#define DMA_REQ_T2_MAT1 (DMA_REQ_TIMER | 5)  //!< Shares line 5 with SSP1 Rx.
+
+/*! Linked list item, as fetched by the controller when a transfer
+ *  completes. Must be word aligned.
+ */
+typedef struct {
+	unsigned int SrcAddr;
+	unsigned int DstAddr;
+	unsigned int NextLLI;   //!< Next item, or 0 to stop.
+	unsigned int Control;   //!< See dma_control().
+} DmaLLI;
+
+
+/*! \brief Initialises the DMA pheriperal module. Further calls do
+ *         nothing, so that every user may call it.
  */
 void dma_init(void);
 
@@ -31,6 +69,15 @@ void dma_setup(char ChannelNum,
 							 unsigned int TransferType,
 							 unsigned int Dmalli  );
 
+/*! \brief Builds the channel control word used by dma_setup(), so that
+ *         linked list items can describe the same kind of transfer.
+ *  \return Value for the DmaLLI Control field.
+ */
+unsigned int dma_control(unsigned int TransferSize,
+												 unsigned int BurstSize,
+												 unsigned int TransferWidth,
+												 unsigned int TransferType);
+
 /*! \brief Enables the DMA chanel. */
 void dma_enable(unsigned char ChannelNum);							 
 
@@ -59,4 +106,12 @@ void dma_transfersize(unsigned char ChannelNum, unsigned int size);
  */
 void dma_set_callback(void (*callback)(void));
 
+/*! \brief Pass a callback for the terminal count interrupt of one channel.
+ *         It runs after the channel's interrupt request has been cleared,
+ *         alongside the callback of dma_set_callback().
+ *  \param ChannelNum  Channel to watch.
+ *  \param callback    Callback function.
+ */
+void dma_set_channel_callback(unsigned char ChannelNum, void (*callback)(void));
+
 #endif //DMA_H
@@ -1,13 +1,42 @@
 #include <platform.h>
 #include <stdint.h>
+#include <string.h>
 #include <gpio.h>
 #include "lcd.h"
 #include "delay.h"
+#include "ssp.h"
+#include "dma.h"
+#include "timebase.h"
 
 /* Modified for use with LPC4088 experiment bundle;
  * Copyright 2016-2017 Johann A. Briffa
  */
 
+// Transport to the serial expander
+#define LCD_BACKEND_GPIO 0   // Bit-banged, about 20 us per expander write
+#define LCD_BACKEND_SSP  1   // SSP0 hardware SPI, see ssp.h
+#define LCD_BACKEND_DMA  2   // Waveforms sent to GPIO by the GPDMA, see below
+#define LCD_BACKEND      LCD_BACKEND_SSP
+#define LCD_SSP_HZ       6000000  // Well inside the 74HC595 limit at 3.3 V
+
+// HD44780 execution time of a data write or of most commands, and of
+// clear and home. The bit-banged bus is slower than the former on its own.
+#define LCD_EXEC_US      40
+#define LCD_CLEAR_US     1520
+
+// 1: bytes are queued and sent from the TIMER2 interrupt, each after the
+// previous one has executed; 0: sent by the caller, which waits them out.
+// The DMA backend is asynchronous by itself and needs TIMER2 for pacing.
+#define LCD_ASYNC        1
+#define LCD_QUEUE_SIZE   128      // Power of two, a full flush takes 64
+#define LCD_QUEUED       (LCD_ASYNC && LCD_BACKEND != LCD_BACKEND_DMA)
+
+//PCONP power control register
+#define PCTIM2           (1UL << 22)
+//MCR / IR: interrupt on match 0
+#define TIM_MCR_INT_MR0  (1UL << 0)
+#define TIM_IR_MR0       (1UL << 0)
+
 // Pin definitions for serial to parallel converter
 #define PIN_SER  P1_24
 #define PIN_SCK  P1_20
@@ -36,6 +65,13 @@ uint8_t _spi_bus;
 
 // Low level writes to LCD serial bus only (serial expander)
 void spi_writeBus() {
+#if LCD_BACKEND == LCD_BACKEND_SSP
+	ssp_write(&_spi_bus, 1);
+	ssp_flush();
+	// clock data to output latches, well over the 74HC595 minimum pulse.
+	gpio_set(PIN_RCK, 1);
+	gpio_set(PIN_RCK, 0);
+#else
 	uint8_t c = _spi_bus;
 	int i;
 	for (i = 0; i < 8; i++) {
@@ -54,17 +90,22 @@ void spi_writeBus() {
 	gpio_set(PIN_RCK, 1);
 	delay_us(1);
 	gpio_set(PIN_RCK, 0);
+#endif
 }
 
 // Initialization
 void spi_init(void) {
+#if LCD_BACKEND == LCD_BACKEND_SSP
+	// SER and SCK are driven by SSP0, only the latch stays a GPIO
+	ssp_init(LCD_SSP_HZ);
+#else
 	// set the relevant pins as output
 	gpio_set_mode(PIN_SER, Output);
 	gpio_set_mode(PIN_SCK, Output);
-	gpio_set_mode(PIN_RCK, Output);
-	// set all pins to low
 	gpio_set(PIN_SER, 0);
 	gpio_set(PIN_SCK, 0);
+#endif
+	gpio_set_mode(PIN_RCK, Output);
 	gpio_set(PIN_RCK, 0);
 
 	// Init the portexpander bus
@@ -74,95 +115,433 @@ void spi_init(void) {
 	spi_writeBus();
 }
 
-// Set E pin
-void lcd_setEnable(char value) {
+#if LCD_BACKEND == LCD_BACKEND_DMA
+// *** Internal functions - DMA waveforms ***
+
+// SER, SCK and RCK all sit on GPIO1, so any state of the three takes one
+// write to its SET register and one to its CLR register. One channel feeds
+// SET words on TIMER2 match 0, the other CLR words on match 1, half a step
+// later. An expander write is always the same run of states for a given
+// image, so the runs of all images are constant tables, and a transfer is
+// a linked list pointing into them. lcd_init() itself is still bit-banged.
+#define LCD_DMA_SET_CHANNEL  6       // Lowest priorities, the sampler has 0
+#define LCD_DMA_CLR_CHANNEL  7
+#define LCD_DMA_PORT         GET_GPIO_PORT(PIN_SER)
+#define LCD_DMA_STEP_NS      500     // One bus state, SCK runs at 1 MHz
+#define LCD_DMA_STEPS_PER_US (1000 / LCD_DMA_STEP_NS)
+#define LCD_DMA_WRITE_STEPS  17      // 8 bits of 2 states, then the latch
+#define LCD_DMA_IMAGES       64      // Any image of D4-D7, RS and E
+#define LCD_DMA_BATCHES      4       // Transfers in the ring, a power of two
+#define LCD_DMA_BATCH_BYTES  9       // At least, as no byte takes more than LCD_DMA_BYTE_ITEMS
+#define LCD_DMA_BYTE_ITEMS   6       // Up to 5 expander writes and the wait
+#define LCD_DMA_BATCH_ITEMS  (LCD_DMA_BATCH_BYTES * LCD_DMA_BYTE_ITEMS)
+#define LCD_DMA_MAX_STEPS    0xFFF   // Transfer size field of an item
+#define LCD_DMA_TIMEOUT_US   50000   // Waiting for a batch, which takes 14 ms at worst
+
+#if (D_LCD_D4 | D_LCD_D5 | D_LCD_D6 | D_LCD_D7 | D_LCD_RS | D_LCD_E) >= LCD_DMA_IMAGES
+#error "The DMA waveforms need the LCD on the low six expander pins"
+#endif
+#if LCD_DMA_BATCHES * LCD_DMA_BATCH_BYTES < LCD_ROWS * (LCD_COLUMNS + 1)
+#error "The ring must hold a full flush, every cell and a cursor move per row"
+#endif
+#if LCD_CLEAR_US * LCD_DMA_STEPS_PER_US > LCD_DMA_MAX_STEPS
+#error "A clear must fit in one DMA wait item"
+#endif
+
+//MCR: reset on match 2; IR: match 0 and 1, which also raise the requests
+#define TIM_MCR_RESET_MR2 (1UL << 7)
+#define TIM_IR_MR0_MR1    (3UL << 0)
+
+// Pins after step s of the write of an image. SER is set up with SCK low,
+// then SCK rises, MSB first. Each run starts and ends with only RCK high,
+// so that runs may follow each other in any order.
+#define WAVE_SER             (1UL << GET_PIN_INDEX(PIN_SER))
+#define WAVE_SCK             (1UL << GET_PIN_INDEX(PIN_SCK))
+#define WAVE_RCK             (1UL << GET_PIN_INDEX(PIN_RCK))
+#define WAVE_PINS(image, s)  ((s) < 0 || (s) >= 16 ? WAVE_RCK : \
+                              ((((image) >> (7 - ((s) & 15) / 2)) & 1) ? WAVE_SER : 0) | ((s) & 1 ? WAVE_SCK : 0))
+#define WAVE_SET(image, s)   (WAVE_PINS(image, s) & ~WAVE_PINS(image, (s) - 1))
+#define WAVE_CLR(image, s)   (WAVE_PINS(image, (s) - 1) & ~WAVE_PINS(image, s))
+#define WAVE_RUN(f, i)       { f(i, 0), f(i, 1), f(i, 2), f(i, 3), f(i, 4), f(i, 5), f(i, 6), f(i, 7), f(i, 8), \
+                               f(i, 9), f(i, 10), f(i, 11), f(i, 12), f(i, 13), f(i, 14), f(i, 15), f(i, 16) }
+#define WAVE_RUNS4(f, i)     WAVE_RUN(f, i), WAVE_RUN(f, (i) + 1), WAVE_RUN(f, (i) + 2), WAVE_RUN(f, (i) + 3)
+#define WAVE_RUNS16(f, i)    WAVE_RUNS4(f, i), WAVE_RUNS4(f, (i) + 4), WAVE_RUNS4(f, (i) + 8), WAVE_RUNS4(f, (i) + 12)
+#define WAVE_RUNS64(f)       WAVE_RUNS16(f, 0), WAVE_RUNS16(f, 16), WAVE_RUNS16(f, 32), WAVE_RUNS16(f, 48)
+
+#if LCD_DMA_WRITE_STEPS != 17 || LCD_DMA_IMAGES != 64
+#error "WAVE_RUN and WAVE_RUNS64 spell out the table sizes"
+#endif
+
+// Linked lists for both channels, item n of one paired with item n of
+// the other
+typedef struct {
+	DmaLLI set[LCD_DMA_BATCH_ITEMS];
+	DmaLLI clr[LCD_DMA_BATCH_ITEMS];
+	int items;
+	unsigned int last_control;   // Last item's control word, with the interrupt
+} LcdDmaBatch;
+
+// In flash, which the GPDMA reads as well as RAM
+static const uint32_t wave_set[LCD_DMA_IMAGES][LCD_DMA_WRITE_STEPS] = { WAVE_RUNS64(WAVE_SET) };
+static const uint32_t wave_clr[LCD_DMA_IMAGES][LCD_DMA_WRITE_STEPS] = { WAVE_RUNS64(WAVE_CLR) };
+static const uint32_t wave_none = 0;  // Source of the waits, a no-op on SET and CLR
+
+// A ring of batches: the one after the last submitted is built while the
+// DMA sends the others in order
+static LcdDmaBatch batches[LCD_DMA_BATCHES];
+static volatile unsigned int batch_head = 0;  // Batches submitted
+static volatile unsigned int batch_tail = 0;  // Batches the DMA has finished
+static int building = 0;              // Set while batches[batch_head % LCD_DMA_BATCHES] fills
+static int lcd_dma_on = 0;            // Set once lcd_init() has finished, cleared if the DMA stalls
+static int request_depth = 0;         // Nesting of lcd_request_begin()
+
+// Programs a channel with the first item of a list. A batch always opens
+// with an expander write.
+static void lcd_dma_channel(char channel, DmaLLI *list, unsigned int request) {
+	dma_setup(channel, list->SrcAddr, list->DstAddr, DMA_REQ_NONE, request,
+	          LCD_DMA_WRITE_STEPS, DMA_BURST_1, DMA_WIDTH_WORD,
+	          DMA_M2P | DMA_NO_IRQ, list->NextLLI);
+	dma_enable(channel);
+}
+
+// Called with the DMA idle and TIMER2 held in reset
+static void lcd_dma_start(unsigned int batch) {
+	LPC_TIM2 -> IR = TIM_IR_MR0_MR1;  //Drop requests left by the last transfer
+	lcd_dma_channel(LCD_DMA_SET_CHANNEL, batches[batch].set, DMA_REQ_T2_MAT0);
+	lcd_dma_channel(LCD_DMA_CLR_CHANNEL, batches[batch].clr, DMA_REQ_T2_MAT1);
+	LPC_TIM2 -> TCR = 1;               //Release reset, start pacing
+}
+
+// The CLR channel ends a batch, half a step after the SET channel
+static void lcd_dma_done(void) {
+	LPC_TIM2 -> TCR = 2;               //Stop and hold in reset
+	batch_tail++;
+	if (batch_tail != batch_head) lcd_dma_start(batch_tail % LCD_DMA_BATCHES);
+}
+
+// TIMER2 counts peripheral clocks; a step lasts one period, with SET
+// words on match 0 and CLR words half a period later on match 1
+static void lcd_dma_init(void) {
+	uint32_t ticks = PeripheralClock / 1000000 * LCD_DMA_STEP_NS / 1000;
+
+	timebase_init();
+	dma_init();
+	dma_set_channel_callback(LCD_DMA_CLR_CHANNEL, lcd_dma_done);
+
+	LPC_SC -> PCONP |= PCTIM2;
+	LPC_TIM2 -> TCR = 2;
+	LPC_TIM2 -> CTCR = 0;
+	LPC_TIM2 -> PR = 0;
+	LPC_TIM2 -> MR0 = 1;
+	LPC_TIM2 -> MR1 = 1 + ticks / 2;
+	LPC_TIM2 -> MR2 = ticks - 1;
+	LPC_TIM2 -> MCR = TIM_MCR_RESET_MR2;
+	lcd_dma_on = 1;
+}
 
-	if (value) {
-		_spi_bus |= D_LCD_E;     // Set E bit
+// Appends an item of @p steps words to both lists
+static void lcd_dma_item(const uint32_t *set, const uint32_t *clr, int steps, unsigned int type) {
+	LcdDmaBatch *batch = &batches[batch_head % LCD_DMA_BATCHES];
+	DmaLLI *s = &batch->set[batch->items];
+	DmaLLI *c = &batch->clr[batch->items];
+	unsigned int control = dma_control(steps, DMA_BURST_1, DMA_WIDTH_WORD, DMA_M2P | DMA_NO_IRQ | type);
+
+	s->SrcAddr = (uint32_t)set;
+	s->DstAddr = (uint32_t)&LCD_DMA_PORT -> SET;
+	s->NextLLI = 0;
+	s->Control = control;
+	c->SrcAddr = (uint32_t)clr;
+	c->DstAddr = (uint32_t)&LCD_DMA_PORT -> CLR;
+	c->NextLLI = 0;
+	c->Control = control;
+	if (batch->items > 0) {
+		batch->set[batch->items - 1].NextLLI = (uint32_t)s;
+		batch->clr[batch->items - 1].NextLLI = (uint32_t)c;
 	}
-	else {
-		_spi_bus &= ~D_LCD_E;    // Reset E bit
+	batch->last_control = dma_control(steps, DMA_BURST_1, DMA_WIDTH_WORD, DMA_M2P | type);
+	batch->items++;
+}
+
+static void lcd_dma_write(uint8_t image) {
+	lcd_dma_item(wave_set[image], wave_clr[image], LCD_DMA_WRITE_STEPS, 0);
+}
+
+// Waits out the execution of the byte just written. The controller takes
+// the next nibble at the end of the second write after the wait.
+static void lcd_dma_wait(unsigned int us) {
+	int steps = us * LCD_DMA_STEPS_PER_US - 2 * LCD_DMA_WRITE_STEPS;
+
+	if (steps < 1) steps = 1;
+	lcd_dma_item(&wave_none, &wave_none, steps, DMA_SRC_FIXED);
+}
+
+// Hands the batch being built to the DMA, or queues it behind the ones
+// being sent
+static void lcd_dma_submit(void) {
+	LcdDmaBatch *batch = &batches[batch_head % LCD_DMA_BATCHES];
+
+	if (!building) return;
+	batch->clr[batch->items - 1].Control = batch->last_control;
+	building = 0;
+
+	__disable_irq();
+	if (batch_tail == batch_head) {
+		lcd_dma_start(batch_head % LCD_DMA_BATCHES);
 	}
+	batch_head++;
+	__enable_irq();
+}
+
+// Gives up on a transfer that never finished and on the ones queued
+// behind it. The bus is left idle for the CPU, which drives it from now on.
+static void lcd_dma_abort(void) {
+	__disable_irq();
+	LPC_TIM2 -> TCR = 2;
+	dma_disable(LCD_DMA_SET_CHANNEL);
+	dma_disable(LCD_DMA_CLR_CHANNEL);
+	dma_clean(LCD_DMA_SET_CHANNEL);
+	dma_clean(LCD_DMA_CLR_CHANNEL);
+	batch_tail = batch_head;
+	building = 0;
+	lcd_dma_on = 0;
+	__enable_irq();
 
-  // write the new data to the SPI portexpander
-  spi_writeBus();
+	gpio_set(PIN_SCK, 0);
+	gpio_set(PIN_RCK, 0);
 }
 
-// Set RS pin
-void lcd_setRS(char value) {
+// Makes room for one byte, waiting for the DMA to free a batch if all of
+// them are taken.
+// Returns 0 if none was freed within LCD_DMA_TIMEOUT_US; the DMA has then
+// been given up.
+static int lcd_dma_reserve(void) {
+	uint32_t start;
+
+	if (building) {
+		if (batches[batch_head % LCD_DMA_BATCHES].items + LCD_DMA_BYTE_ITEMS <= LCD_DMA_BATCH_ITEMS) return 1;
+		lcd_dma_submit();
+	}
+	start = timebase_now_us();
+	while (batch_head - batch_tail >= LCD_DMA_BATCHES) {
+		if (timebase_now_us() - start > LCD_DMA_TIMEOUT_US) {
+			lcd_dma_abort();
+			return 0;
+		}
+	}
+	building = 1;
+	batches[batch_head % LCD_DMA_BATCHES].items = 0;
+	return 1;
+}
 
-  if (value) {
-    _spi_bus |= D_LCD_RS;    // Set RS bit
-  }
-  else {
-    _spi_bus &= ~D_LCD_RS;   // Reset RS bit
-  }
+// Bytes written between the outermost begin and end go out as one
+// transfer; a byte written outside of them goes out on its own.
+static void lcd_request_begin(void) {
+	request_depth++;
+}
 
-  // write the new data to the SPI portexpander
-  spi_writeBus();
+static void lcd_request_end(void) {
+	if (--request_depth == 0) lcd_dma_submit();
 }
 
-// Place the 4bit data on the databus
-void lcd_setData(int value) {
-  int data = value & 0x0F;
+static void lcd_resync(void);
+#else
+static void lcd_request_begin(void) {}
+static void lcd_request_end(void) {}
+#endif
 
-  // Set bit by bit to support any mapping of expander portpins to LCD pins
+// *** Internal functions - bus transactions ***
 
-  if (data & 0x01) {
-    _spi_bus |= D_LCD_D4;   // Set Databit
-  }
-  else {
-    _spi_bus &= ~D_LCD_D4;  // Reset Databit
-  }
+// Expander image of a nibble on D4-D7. Built bit by bit to support any
+// mapping of expander portpins to LCD pins.
+static uint8_t lcd_data_bits(uint8_t nibble) {
+	uint8_t bits = 0;
 
-  if (data & 0x02) {
-    _spi_bus |= D_LCD_D5;   // Set Databit
-  }
-  else {
-    _spi_bus &= ~D_LCD_D5;  // Reset Databit
-  }
+	if (nibble & 0x01) bits |= D_LCD_D4;
+	if (nibble & 0x02) bits |= D_LCD_D5;
+	if (nibble & 0x04) bits |= D_LCD_D6;
+	if (nibble & 0x08) bits |= D_LCD_D7;
+	return bits;
+}
 
-  if (data & 0x04) {
-    _spi_bus |= D_LCD_D6;   // Set Databit
-  }
-  else {
-    _spi_bus &= ~D_LCD_D6;  // Reset Databit
-  }
+// Latches a whole image into the expander
+static void lcd_bus_write(uint8_t image) {
+	_spi_bus = image;
+#if LCD_BACKEND == LCD_BACKEND_DMA
+	if (lcd_dma_on) {
+		lcd_dma_write(image);
+		return;
+	}
+#endif
+	spi_writeBus();
+}
 
-  if (data & 0x08) {
-    _spi_bus |= D_LCD_D7;   // Set Databit
-  }
-  else {
-    _spi_bus &= ~D_LCD_D7;  // Reset Databit
-  }
+// Sends a nibble with RS, data and E set together in one image, then E
+// low again in a second one; the controller latches on the falling edge.
+// RS must be stable before E rises, so it gets a write of its own, with E
+// low, only when it changes.
+static void lcd_write_nibble(int rs, uint8_t nibble) {
+	uint8_t image = lcd_data_bits(nibble) | (rs ? D_LCD_RS : 0);
 
-  // write the new data to the SPI portexpander
-  spi_writeBus();
+	if ((_spi_bus ^ image) & D_LCD_RS) {
+		lcd_bus_write((_spi_bus & ~D_LCD_RS) | (image & D_LCD_RS));
+	}
+	lcd_bus_write(image | D_LCD_E);
+	lcd_bus_write(image);
 }
 
 
 // *** Internal functions - controller interface ***
 
-void lcd_write_4bit(uint8_t c) {
-	lcd_setEnable(1);
-	lcd_setData(c & 0x0F);
-	delay_us(1);
-	lcd_setEnable(0);
-	delay_us(1);
+// Microseconds until the controller takes the next byte
+static unsigned int lcd_exec_us(int rs, uint8_t c) {
+	return (!rs && c <= 0x03) ? LCD_CLEAR_US : LCD_EXEC_US;
+}
+
+static void lcd_send_byte(int rs, uint8_t c) {
+	lcd_write_nibble(rs, c>>4);
+	lcd_write_nibble(rs, c & 0x0F);
+}
+
+#if LCD_QUEUED
+// Queue entry: the byte, with RS in bit 8
+#define LCD_QUEUE_RS     (1U << 8)
+
+// Single producer (callers), single consumer (TIMER2_IRQHandler)
+static uint16_t lcd_queue[LCD_QUEUE_SIZE];
+static volatile unsigned int queue_head = 0;
+static volatile unsigned int queue_tail = 0;
+static volatile int queue_busy = 0;   // Set while the interrupt has a byte executing
+static int lcd_async = 0;             // Set once lcd_init() has finished
+
+// TIMER2 counts microseconds; MR0 fires once the byte sent last has
+// executed
+static void lcd_queue_init(void) {
+	LPC_SC -> PCONP |= PCTIM2;
+	LPC_TIM2 -> TCR = 0;
+	LPC_TIM2 -> CTCR = 0;
+	LPC_TIM2 -> PR = PeripheralClock / 1000000 - 1;
+	LPC_TIM2 -> MCR = TIM_MCR_INT_MR0;
+	LPC_TIM2 -> IR = 0xFFFFFFFF;
+	LPC_TIM2 -> TCR |= (1<<1);  //Reset Counter
+	LPC_TIM2 -> TCR &= ~(1<<1); //release reset
+	LPC_TIM2 -> TCR |= 1;
+
+	NVIC_SetPriority(TIMER2_IRQn, 3);
+	NVIC_ClearPendingIRQ(TIMER2_IRQn);
+	NVIC_EnableIRQ(TIMER2_IRQn);
+	lcd_async = 1;
+}
+
+static void lcd_queue_push(uint16_t entry) {
+	// Back-pressure: the interrupt frees a slot every LCD_EXEC_US
+	while (queue_head - queue_tail >= LCD_QUEUE_SIZE);
+
+	lcd_queue[queue_head % LCD_QUEUE_SIZE] = entry;
+	__DMB();                // Entry written before it is published
+	queue_head++;
+
+	// The interrupt only clears queue_busy after finding the queue empty,
+	// so either it sees this entry or it is started here
+	if (!queue_busy) {
+		queue_busy = 1;
+		NVIC_SetPendingIRQ(TIMER2_IRQn);
+	}
+}
+
+void TIMER2_IRQHandler(void) {
+	uint16_t entry;
+	int rs;
+
+	LPC_TIM2 -> IR = TIM_IR_MR0;
+	if (queue_tail == queue_head) {
+		queue_busy = 0;
+		return;
+	}
+
+	entry = lcd_queue[queue_tail % LCD_QUEUE_SIZE];
+	queue_tail++;
+	rs = !!(entry & LCD_QUEUE_RS);
+	lcd_send_byte(rs, (uint8_t)entry);
+	LPC_TIM2 -> MR0 = LPC_TIM2 -> TC + lcd_exec_us(rs, (uint8_t)entry);
+}
+#endif
+
+static void lcd_write_byte(int rs, uint8_t c) {
+	unsigned int exec = lcd_exec_us(rs, c);
+
+#if LCD_QUEUED
+	if (lcd_async) {
+		lcd_queue_push((rs ? LCD_QUEUE_RS : 0) | c);
+		return;
+	}
+#elif LCD_BACKEND == LCD_BACKEND_DMA
+	if (lcd_dma_on) {
+		if (lcd_dma_reserve()) {
+			lcd_send_byte(rs, c);
+			lcd_dma_wait(exec);
+			if (request_depth == 0) lcd_dma_submit();
+			return;
+		}
+		lcd_resync();
+	}
+#endif
+
+	lcd_send_byte(rs, c);
+	if (LCD_BACKEND != LCD_BACKEND_GPIO || exec > LCD_EXEC_US) {
+		delay_us(exec);
+	}
 }
 
 static void lcd_write_data(uint8_t c) {
-	lcd_setRS(1);
-	lcd_write_4bit(c>>4);
-	lcd_write_4bit(c);
+	lcd_write_byte(1, c);
 }
 
 void lcd_write_cmd(uint8_t c) {
-	lcd_setRS(0);
-	lcd_write_4bit(c>>4);
-	lcd_write_4bit(c);
+	lcd_write_byte(0, c);
 }
 
+// *** Shadow framebuffer ***
+
+// Text the application wants shown, and what the controller shows. A
+// cell of the latter is 0 while unknown, e.g. before the first clear.
+static char lcd_fb[LCD_ROWS][LCD_COLUMNS];
+static char lcd_shown[LCD_ROWS][LCD_COLUMNS];
+
+// Controller cursor, kept by every exported function. The column runs
+// past LCD_COLUMNS into the hidden part of the line.
+static int cursor_column;
+static int cursor_row;
+
+// Runs the LCD initialisation sequence, which also brings the controller
+// back in step if it was left in the middle of a byte.
+static void lcd_setup(void) {
+	lcd_write_nibble(0, 0x3);
+	delay_us(4100);
+	lcd_write_nibble(0, 0x3);
+	delay_us(100);
+	lcd_write_nibble(0, 0x3);
+	delay_us(100);
+	lcd_write_nibble(0, 0x2);
+	delay_us(100);
+	lcd_write_cmd(0x28); // Function set.
+	lcd_write_cmd(0x0C);
+	lcd_write_cmd(0x06);
+}
+
+#if LCD_BACKEND == LCD_BACKEND_DMA
+// After the DMA was given up with bytes still to send: the controller is
+// set up again and the cursor put back where the caller expects it, and
+// the next flush redraws every cell.
+static void lcd_resync(void) {
+	int column = cursor_column;
+	int row = cursor_row;
+
+	lcd_setup();
+	lcd_set_cursor(column, row);
+	memset(lcd_shown, 0, sizeof(lcd_shown));
+}
+#endif
+
 // *** Exported functions ***
 
 // Initialises the LCD module.
@@ -171,17 +550,16 @@ void lcd_init(void) {
 	spi_init();
 
 	// Run LCD initilisation sequence
-	lcd_setRS(0);
-	lcd_write_4bit(0x3);
-	delay_us(4100);
-	lcd_write_4bit(0x3);
-	delay_us(100);
-	lcd_write_4bit(0x3);
-	lcd_write_4bit(0x2);
-	lcd_write_cmd(0x28); // Function set.
-	lcd_write_cmd(0x0C);
-	lcd_write_cmd(0x06);
+	lcd_setup();
 	lcd_set_cursor(0, 0);
+
+	memset(lcd_shown, 0, sizeof(lcd_shown));
+	memset(lcd_fb, ' ', sizeof(lcd_fb));
+#if LCD_QUEUED
+	lcd_queue_init();
+#elif LCD_BACKEND == LCD_BACKEND_DMA
+	lcd_dma_init();
+#endif
 }
 
 // Enables or disables visibility of the cursor.
@@ -195,24 +573,87 @@ void lcd_set_cursor(int column, int row) {
 	address = (row * 0x40) + column;
 	address |= 0x80;
 	lcd_write_cmd(address);
+	cursor_column = column;
+	cursor_row = row;
 }
 
 // Clears the LCD and relocates the cursor to {0,0}.
 void lcd_clear(void) {
 	lcd_write_cmd(0x01);
-	delay_us(1520);
+	memset(lcd_shown, ' ', sizeof(lcd_shown));
+	cursor_column = 0;
+	cursor_row = 0;
 }
 
 // Prints the specified character to the LCD and increments the cursor.
 void lcd_put_char(char c) {
 	lcd_write_data(c);
+	if (cursor_column < LCD_COLUMNS) {
+		lcd_shown[cursor_row][cursor_column] = c;
+	}
+	cursor_column++;
 }
 
 // Prints the null terminated string to the LCD and increments the cursor.
+// RS is only switched before the first character, so every further one
+// costs four expander writes.
 void lcd_print(char *string) {
+	lcd_request_begin();
 	while(*string) {
 		lcd_put_char(*string++);
 	}
+	lcd_request_end();
+}
+
+// Non-zero once every queued byte has been sent and executed.
+int lcd_queue_idle(void) {
+#if LCD_QUEUED
+	return !queue_busy && queue_tail == queue_head;
+#elif LCD_BACKEND == LCD_BACKEND_DMA
+	return batch_head == batch_tail && !building;
+#else
+	return 1;
+#endif
+}
+
+// Fills the framebuffer with spaces.
+void lcd_fb_clear(void) {
+	memset(lcd_fb, ' ', sizeof(lcd_fb));
+}
+
+// Fills one row of the framebuffer with spaces.
+void lcd_fb_clear_row(int row) {
+	memset(lcd_fb[row], ' ', LCD_COLUMNS);
+}
+
+// Writes a string into the framebuffer, cut at the end of the row.
+void lcd_fb_print(int column, int row, const char *string) {
+	while (*string && column < LCD_COLUMNS) {
+		lcd_fb[row][column++] = *string++;
+	}
+}
+
+// Sends the cells that differ from what the controller shows. A run of
+// changed cells costs one cursor move, as the cursor then advances by
+// itself; rewriting an unchanged cell would cost as much as that move.
+int lcd_fb_flush(void) {
+	int sent = 0;
+	int row, column;
+
+	lcd_request_begin();
+	for (row = 0; row < LCD_ROWS; row++) {
+		for (column = 0; column < LCD_COLUMNS; column++) {
+			if (lcd_fb[row][column] == lcd_shown[row][column]) continue;
+			if (cursor_row != row || cursor_column != column) {
+				lcd_set_cursor(column, row);
+				sent++;
+			}
+			lcd_put_char(lcd_fb[row][column]);
+			sent++;
+		}
+	}
+	lcd_request_end();
+	return sent;
 }
 
 // *******************************ARM University Program Copyright © ARM Ltd 2014*************************************
@@ -9,7 +9,22 @@
 #ifndef LCD_H
 #define LCD_H
 
+#define LCD_COLUMNS 16
+#define LCD_ROWS    2
+
 /*! \brief Initialises the LCD module.
+ *
+ *  With LCD_ASYNC (lcd.c) every function after it only queues its
+ *  bytes: the TIMER2 interrupt sends each one once the controller has
+ *  executed the one before, so callers never wait on the display unless
+ *  the queue is full. lcd_queue_idle() tells when everything has reached
+ *  the display.
+ *
+ *  With LCD_BACKEND_DMA instead, each call builds the expander waveforms
+ *  of its bytes and hands them to the GPDMA, which writes them to GPIO
+ *  paced by TIMER2; callers only wait while the ring of transfers is
+ *  full. Should the DMA stall, the driver gives it up, sets the controller
+ *  up again and drives the bus itself from then on.
  */
 void lcd_init(void);
 
@@ -40,4 +55,37 @@ void lcd_put_char(char c);
  */
 void lcd_set_cursor_visibile(int visible);
 
+/*! \brief Checks whether the display has caught up.
+ *  \return Non-zero once every queued byte has been sent and executed.
+ */
+int lcd_queue_idle(void);
+
+/*! \brief Fills the shadow framebuffer with spaces. Like every lcd_fb_
+ *         function, it only changes RAM until lcd_fb_flush().
+ */
+void lcd_fb_clear(void);
+
+/*! \brief Fills one row of the shadow framebuffer with spaces.
+ *  \param row  Row to clear.
+ */
+void lcd_fb_clear_row(int row);
+
+/*! \brief Writes a string into the shadow framebuffer, cut at the end
+ *         of the row.
+ *  \param column  First column to write.
+ *  \param row     Row to write.
+ *  \param string  Null terminated string.
+ */
+void lcd_fb_print(int column, int row, const char *string);
+
+/*! \brief Sends the cells of the shadow framebuffer that differ from the
+ *         display, moving the cursor only between runs of changed cells.
+ *
+ *  The other functions keep track of what they write, so they may be
+ *  mixed with the framebuffer.
+ *
+ *  \return Bytes sent to the controller, characters and cursor moves.
+ */
+int lcd_fb_flush(void);
+
 #endif // LDC_H
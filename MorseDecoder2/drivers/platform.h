@@ -266,6 +266,8 @@ typedef enum {
 #define  P_DAC          P0_26
 #define  P_CMP_PLUS     P0_9
 #define  P_CMP_NEG      P0_8
+#define  P_CAP          P1_18
+
 
 
 /* Other useful macros */
@@ -341,6 +343,7 @@ P_ADC          P0_24       //P16 (ADC0_IN[1])
 P_DAC          P0_26       //P18
 P_CMP_PLUS     P0_9        //P11 (CMP1_IN[2])   VP
 P_CMP_NEG      P0_8        //P12 (CMP1_IN[3])   VM
+P_CAP          P1_18       //T1_CAP0, squared-up tone for the frequency meter
 										
 */
 // *******************************ARM University Program Copyright  ARM Ltd 2014*************************************   
@@ -0,0 +1,65 @@
+#include <platform.h>
+#include <timebase.h>
+#include <power.h>
+
+#define IRC_FREQ              12000000UL
+
+//SCS register
+#define SCS_OSCEN             (1UL << 5)
+#define SCS_OSCSTAT           (1UL << 6)
+//CCLKSEL register: CPU clock from PLL0 instead of sysclk
+#define CCLKSEL_PLL           (1UL << 8)
+//PLL0STAT register
+#define PLL0STAT_PLOCK        (1UL << 10)
+
+static void pll0_feed(void) {
+
+	LPC_SC -> PLL0FEED = 0xAA;
+	LPC_SC -> PLL0FEED = 0x55;
+
+}
+
+uint32_t power_sleep(PowerMode mode) {
+
+	uint32_t cclksel = LPC_SC -> CCLKSEL;
+	uint32_t clksrcsel = LPC_SC -> CLKSRCSEL;
+	uint32_t start, ticks;
+
+	__disable_irq();
+
+	LPC_SC -> PCON = 0;  //PM = 0: Sleep, or Deep-sleep with SLEEPDEEP
+	if (mode == PowerDeepSleep) {
+		//Wake up on the IRC with PLL0 off, as SystemInit() starts
+		LPC_SC -> CCLKSEL = cclksel & ~CCLKSEL_PLL;
+		LPC_SC -> CLKSRCSEL = 0;
+		LPC_SC -> PLL0CON = 0;
+		pll0_feed();
+		SCB -> SCR |= SCB_SCR_SLEEPDEEP_Msk;
+	}
+
+	__DSB();
+	__WFI();  //The pending interrupt ends the sleep but is not taken yet
+
+	if (mode != PowerDeepSleep) {
+		__enable_irq();
+		return 0;
+	}
+	SCB -> SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+	//Same sequence as SystemInit()
+	start = timebase_now_us();
+	LPC_SC -> SCS |= SCS_OSCEN;
+	while (!(LPC_SC -> SCS & SCS_OSCSTAT));
+	LPC_SC -> CLKSRCSEL = clksrcsel;
+	LPC_SC -> PLL0CON = 0x01;
+	pll0_feed();
+	while (!(LPC_SC -> PLL0STAT & PLL0STAT_PLOCK));
+	ticks = timebase_now_us() - start;
+	LPC_SC -> CCLKSEL = cclksel;
+
+	__enable_irq();
+
+	//The timebase counted PCLK divided down from the IRC meanwhile
+	return (uint32_t)((uint64_t)ticks * PeripheralClock / (IRC_FREQ / (LPC_SC -> PCLKSEL & 0x1F)));
+
+}
@@ -0,0 +1,30 @@
+/*!
+ * \file      power.h
+ * \brief     Sleep and Deep-sleep modes of the CPU.
+ */
+#ifndef POWER_H
+#define POWER_H
+#include <stdint.h>
+
+/*! Power mode entered by power_sleep(). */
+typedef enum {
+	PowerSleep,     //!< CPU clock stopped, peripherals keep running.
+	PowerDeepSleep  //!< Oscillator, PLL0 and all peripheral clocks stopped.
+} PowerMode;
+
+/*! \brief Sleeps until an enabled interrupt is pending.
+ *
+ *  Returns before that interrupt is handled. After Deep-sleep the main
+ *  oscillator and PLL0 are restarted first, so its handler already runs
+ *  at full speed.
+ *
+ *  \warning Peripheral clocks stop in Deep-sleep, the timebase (see
+ *           timebase.h) included. Only wake-up capable interrupts, such
+ *           as the GPIO and comparator ones, end it.
+ *
+ *  \param mode  Power mode to enter.
+ *  \return      Microseconds spent restoring the clocks, 0 after Sleep.
+ */
+uint32_t power_sleep(PowerMode mode);
+
+#endif // POWER_H
@@ -0,0 +1,83 @@
+#include <platform.h>
+#include <ssp.h>
+
+#define PIN_SCK0              P1_20
+#define PIN_MOSI0             P1_24
+#define SSP0_PIN_FUNC         5
+
+//PCONP power control register
+#define PCSSP0                (1UL << 21)
+
+//CR0: 8-bit frames, SPI format, CPOL = CPHA = 0
+#define SSP_CR0_DSS_8         (7UL << 0)
+#define SSP_CR0_SCR(n)        ((uint32_t)((n) & 0xFF) << 8)
+//CR1: enable, master
+#define SSP_CR1_SSE           (1UL << 1)
+//SR: transmit FIFO not full, receive FIFO not empty, busy
+#define SSP_SR_TNF            (1UL << 1)
+#define SSP_SR_RNE            (1UL << 2)
+#define SSP_SR_BSY            (1UL << 4)
+
+static void ssp_pin_func(Pin pin) {
+
+	uint32_t* iocon = GET_IOCON(pin);
+	*iocon &= ~7;
+	*iocon |= SSP0_PIN_FUNC;
+
+}
+
+//Every sent frame also receives one, drop them so the receive FIFO
+//never overruns
+static void ssp_drain_rx(void) {
+
+	while (LPC_SSP0 -> SR & SSP_SR_RNE) {
+		(void)LPC_SSP0 -> DR;
+	}
+
+}
+
+void ssp_init(uint32_t hz) {
+
+	uint32_t cpsr = 2;
+	uint32_t scr;
+
+	LPC_SC -> PCONP |= PCSSP0;
+	ssp_pin_func(PIN_SCK0);
+	ssp_pin_func(PIN_MOSI0);
+
+	//Bit rate = PCLK / (CPSR * (SCR + 1)), CPSR even and at least 2
+	while (1) {
+		scr = (PeripheralClock + cpsr * hz - 1) / (cpsr * hz) - 1;
+		if (scr <= 0xFF || cpsr == 254) break;
+		cpsr += 2;
+	}
+
+	LPC_SSP0 -> CR1 = 0;
+	LPC_SSP0 -> CR0 = SSP_CR0_DSS_8 | SSP_CR0_SCR(scr);
+	LPC_SSP0 -> CPSR = cpsr;
+	LPC_SSP0 -> IMSC = 0;
+	LPC_SSP0 -> CR1 = SSP_CR1_SSE;
+	ssp_drain_rx();
+
+}
+
+void ssp_write(const uint8_t *data, int length) {
+
+	while (length > 0) {
+		if (LPC_SSP0 -> SR & SSP_SR_TNF) {
+			LPC_SSP0 -> DR = *data++;
+			length--;
+		}
+		ssp_drain_rx();
+	}
+
+}
+
+void ssp_flush(void) {
+
+	while (LPC_SSP0 -> SR & SSP_SR_BSY) {
+		ssp_drain_rx();
+	}
+	ssp_drain_rx();
+
+}
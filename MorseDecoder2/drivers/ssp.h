@@ -0,0 +1,31 @@
+/*!
+ * \file      ssp.h
+ * \brief     Transmit only SPI master on SSP0.
+ *
+ * SCK0 on P1_20 and MOSI0 on P1_24, the pins of the LCD serial expander.
+ * 8-bit frames, SPI mode 0, MSB first. Nothing is read back.
+ */
+#ifndef SSP_H
+#define SSP_H
+#include <stdint.h>
+
+/*! \brief Initialises SSP0 as SPI master.
+ *  \param hz  Highest acceptable bit rate; the nearest one at or below it
+ *             that PCLK allows is used.
+ */
+void ssp_init(uint32_t hz);
+
+/*! \brief Queues bytes for transmission through the 8-frame transmit
+ *         FIFO, only waiting while it is full.
+ *
+ *  Returns once the last byte is queued, before it has been shifted out.
+ *
+ *  \param data    Bytes to send.
+ *  \param length  Number of bytes.
+ */
+void ssp_write(const uint8_t *data, int length);
+
+/*! \brief Waits until every queued byte has been shifted out. */
+void ssp_flush(void);
+
+#endif // SSP_H
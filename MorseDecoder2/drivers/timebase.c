@@ -0,0 +1,96 @@
+#include <platform.h>
+#include <timebase.h>
+
+//PCONP power control register
+#define PCTIM3                (1UL << 23)
+
+//MCR: interrupt on match n
+#define TIM_MCR_INT(n)        (1UL << ((n) * 3))
+//IR: match n interrupt flag
+#define TIM_IR_MR(n)          (1UL << (n))
+
+static int running = 0;
+static volatile uint32_t armed = 0;          //Bit n set while alarm n is pending
+static void (*alarm_callback[TIMEBASE_ALARMS])(void);
+
+static volatile uint32_t* match_register(TimebaseAlarm alarm) {
+
+	return &LPC_TIM3 -> MR0 + alarm;
+
+}
+
+void timebase_init(void) {
+
+	if (running) return;
+
+	LPC_SC -> PCONP |= PCTIM3;
+
+	//Count microseconds, never reset
+	LPC_TIM3 -> TCR = 0;
+	LPC_TIM3 -> CTCR = 0;
+	LPC_TIM3 -> PR = PeripheralClock / 1000000 - 1;
+	LPC_TIM3 -> MCR = 0;
+	LPC_TIM3 -> IR = 0xFFFFFFFF;
+	LPC_TIM3 -> TCR |= (1<<1);  //Reset Counter
+	LPC_TIM3 -> TCR &= ~(1<<1); //release reset
+	LPC_TIM3 -> TCR |= 1;
+
+	NVIC_SetPriority(TIMER3_IRQn, 3);
+	NVIC_ClearPendingIRQ(TIMER3_IRQn);
+	NVIC_EnableIRQ(TIMER3_IRQn);
+
+	running = 1;
+}
+
+uint32_t timebase_now_us(void) {
+
+	return LPC_TIM3 -> TC;
+
+}
+
+void timebase_alarm(TimebaseAlarm alarm, uint32_t at_us, void (*callback)(void)) {
+
+	NVIC_DisableIRQ(TIMER3_IRQn);
+
+	alarm_callback[alarm] = callback;
+	*match_register(alarm) = at_us;
+	LPC_TIM3 -> IR = TIM_IR_MR(alarm);
+	LPC_TIM3 -> MCR |= TIM_MCR_INT(alarm);
+	armed |= (1UL << alarm);
+
+	//The counter may already be past the match, let the handler catch up
+	if ((int32_t)(at_us - LPC_TIM3 -> TC) <= 0) NVIC_SetPendingIRQ(TIMER3_IRQn);
+
+	NVIC_EnableIRQ(TIMER3_IRQn);
+
+}
+
+void timebase_cancel(TimebaseAlarm alarm) {
+
+	NVIC_DisableIRQ(TIMER3_IRQn);
+	LPC_TIM3 -> MCR &= ~TIM_MCR_INT(alarm);
+	armed &= ~(1UL << alarm);
+	NVIC_EnableIRQ(TIMER3_IRQn);
+
+}
+
+void TIMER3_IRQHandler(void) {
+
+	uint32_t now;
+	int i;
+
+	//Clear the flags before sampling the counter: a match after the
+	//sample sets its flag again and brings the handler back
+	LPC_TIM3 -> IR = LPC_TIM3 -> IR;
+	now = LPC_TIM3 -> TC;
+
+	//Fire every armed alarm that is due, matched or not
+	for (i = 0; i < TIMEBASE_ALARMS; i++) {
+		if ((armed & (1UL << i)) && (int32_t)(now - *match_register((TimebaseAlarm)i)) >= 0) {
+			LPC_TIM3 -> MCR &= ~TIM_MCR_INT(i);
+			armed &= ~(1UL << i);
+			if (alarm_callback[i]) alarm_callback[i]();
+		}
+	}
+
+}
@@ -0,0 +1,41 @@
+/*!
+ * \file      timebase.h
+ * \brief     Free-running microsecond timebase and alarms on TIMER3.
+ */
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+#include <stdint.h>
+
+/*! One-shot alarms, one per TIMER3 match register. */
+typedef enum {
+	AlarmEdgeHold,   //!< End of a comparator mark (edges.c).
+	AlarmEdgePoll,   //!< Silence reporting (edges.c).
+	AlarmScheduler,  //!< Next task deadline.
+	TIMEBASE_ALARMS
+} TimebaseAlarm;
+
+/*! \brief Starts TIMER3 counting microseconds from 0. Further calls do
+ *         nothing, so every user may call it.
+ */
+void timebase_init(void);
+
+/*! \brief Reads the timebase.
+ *  \return Microseconds since timebase_init(), wrapping after 71 minutes.
+ *          Compare times through their signed difference.
+ */
+uint32_t timebase_now_us(void);
+
+/*! \brief Calls \a callback from the TIMER3 interrupt once the timebase
+ *         reaches \a at_us. A time already passed fires at once.
+ *  \param alarm     Alarm to (re)arm.
+ *  \param at_us     Time to fire at, as timebase_now_us().
+ *  \param callback  Callback function, may be 0 to only wake the CPU.
+ */
+void timebase_alarm(TimebaseAlarm alarm, uint32_t at_us, void (*callback)(void));
+
+/*! \brief Disarms an alarm.
+ *  \param alarm  Alarm to cancel.
+ */
+void timebase_cancel(TimebaseAlarm alarm);
+
+#endif // TIMEBASE_H
@@ -13,6 +13,10 @@
 #define MATCHVALUE(n)                   (10000*n)
 //Set Match Register n
 #define TIM_MCR_CHANNEL_SET(n)      ((uint32_t)(3<<(n*3)))
+//CCR: capture CAPn.0 on rising edge with interrupt
+#define TIM_CCR_CAP0_RISE_INT       ((uint32_t)(5<<0))
+//IOCON function of P_CAP as T1_CAP0
+#define CAP_FUNC                    3
 
 
 static void (*timer_callback)(void) = 0;
@@ -78,4 +82,63 @@ void TIMER0_IRQHandler(void){
 	
 }
 
+static void (*capture_callback)(uint32_t count) = 0;
+
+//Using timer 1
+void timer_capture_init(void) {
+	
+	uint32_t* pIOCON = GET_IOCON(P_CAP);
+	
+	// Enable power
+	LPC_SC -> PCONP |= PCTIM1;
+	
+	*pIOCON &= ~0x1F;
+	*pIOCON |= CAP_FUNC;  //T1_CAP0, no pull resistor
+	
+	//Free-running on PCLK, only the capture register is used
+	LPC_TIM1 -> TCR = 0;
+	LPC_TIM1 -> CTCR = 0;
+	LPC_TIM1 -> PR = 0;
+	LPC_TIM1 -> MCR = 0;
+	LPC_TIM1 -> CCR = TIM_CCR_CAP0_RISE_INT;
+	LPC_TIM1 -> TCR |= (1<<1);  //Reset Counter
+	LPC_TIM1 -> TCR &= ~(1<<1); //release reset
+	LPC_TIM1 -> IR = 0xFFFFFFFF;
+	
+}
+
+void timer_capture_set_callback(void (*callback)(uint32_t count)) {
+	
+	capture_callback = callback;
+	
+	NVIC_SetPriority(TIMER1_IRQn, 2);
+	NVIC_ClearPendingIRQ(TIMER1_IRQn);
+	NVIC_EnableIRQ(TIMER1_IRQn);
+	__enable_irq();
+	
+}
+
+void timer_capture_enable(void) {
+	
+	LPC_TIM1 -> TCR |= 1;
+	
+}
+
+void timer_capture_disable(void) {
+	
+	LPC_TIM1 -> TCR = 0;
+	
+}
+
+void TIMER1_IRQHandler(void){
+	
+	if ( ((LPC_TIM1 -> IR) & (0x1 << 4)) != 0 )
+    {
+			// Clear interrupt pending
+			LPC_TIM1 -> IR = (0x1 << 4);
+			if (capture_callback) capture_callback(LPC_TIM1 -> CR0);
+		}
+	
+}
+
 // *******************************ARM University Program Copyright  ARM Ltd 2014*************************************   
@@ -24,6 +24,25 @@ void timer_enable(void);
 /*! \brief Disables the timer. */
 void timer_disable(void);
 
+/*! \brief Initialises TIMER1 to timestamp the rising edges on P_CAP.
+ *
+ *  The timer counts PeripheralClock cycles and is never reset, so the
+ *  difference of two captures is the period between them.
+ */
+void timer_capture_init(void);
+
+/*! \brief Pass a callback to the API, which is executed during the
+ *         capture interrupt with the captured count.
+ *  \param callback  Callback function.
+ */
+void timer_capture_set_callback(void (*callback)(uint32_t count));
+
+/*! \brief Starts the capture timer. */
+void timer_capture_enable(void);
+
+/*! \brief Stops the capture timer. */
+void timer_capture_disable(void);
+
 #endif // TIMER_H
 
 // *******************************ARM University Program Copyright  ARM Ltd 2014*************************************   
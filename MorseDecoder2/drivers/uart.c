@@ -41,12 +41,24 @@
 #define PCUART2                 ((uint8_t )(1<<24))
 #define PCUART0                 ((uint8_t )(1<<3))
 
-float Fractional_Divider_Array [72][3];
+//Fractional divider table: {FR * 1000, DIVADDVAL, MULVAL}, sorted by FR
+static const uint16_t Fractional_Divider_Array [72][3] = {
+	{1000, 0, 1}, {1067, 1,15}, {1071, 1,14}, {1077, 1,13}, {1083, 1,12}, {1091, 1,11},
+	{1100, 1,10}, {1111, 1, 9}, {1125, 1, 8}, {1133, 2,15}, {1143, 1, 7}, {1154, 2,13},
+	{1167, 1, 6}, {1182, 2,11}, {1200, 1, 5}, {1214, 3,14}, {1222, 2, 9}, {1231, 3,13},
+	{1250, 1, 4}, {1267, 4,15}, {1273, 3,11}, {1286, 2, 7}, {1300, 3,10}, {1308, 4,13},
+	{1333, 1, 3}, {1357, 5,14}, {1364, 4,11}, {1375, 3, 8}, {1385, 5,13}, {1400, 2, 5},
+	{1417, 5,12}, {1429, 3, 7}, {1444, 4, 9}, {1455, 5,11}, {1462, 6,13}, {1467, 7,15},
+	{1500, 1, 2}, {1533, 8,15}, {1538, 7,13}, {1545, 6,11}, {1556, 5, 9}, {1571, 4, 7},
+	{1583, 7,12}, {1600, 3, 5}, {1615, 8,13}, {1625, 5, 8}, {1636, 7,11}, {1643, 9,14},
+	{1667, 2, 3}, {1692, 9,13}, {1700, 7,10}, {1714, 5, 7}, {1727, 8,11}, {1733,11,15},
+	{1750, 3, 4}, {1769,10,13}, {1778, 7, 9}, {1786,11,14}, {1800, 4, 5}, {1818, 9,11},
+	{1833, 5, 6}, {1846,11,13}, {1857, 6, 7}, {1867,13,15}, {1875, 7, 8}, {1889, 8, 9},
+	{1900, 9,10}, {1909,10,11}, {1917,11,12}, {1923,12,13}, {1929,13,14}, {1933,14,15},
+};
 
 static void (*UART_callback)(uint8_t);
 
-void FR_TABLE_Value(float input_array[3], float FR, float Div, float Mul);
-void FR_TABLE_Construct(void);
 void uart_set_baudrate(uint32_t baud);
 
 void uart_init(uint32_t baud) {
@@ -80,66 +92,39 @@ void uart_init(uint32_t baud) {
 
 }
 
+//Tries every fractional divider and keeps the one closest to baudrate.
+//The UART is clocked from PCLK: baud = PCLK / (16 * DL * FR).
 void uart_set_baudrate(uint32_t baudrate){
 	
-	uint32_t BAUD_DIVADDVAL, BAUD_MULVAL, BAUD_DLEST;
-	float DLEST, FREST,upper_bound,lower_bound, UART_CLK;
-	int int_DLEST;
-	int table_item = 35;
+	uint32_t BAUD_DIVADDVAL = 0, BAUD_MULVAL = 1, BAUD_DLEST = 0;
+	uint32_t best_error = 0xFFFFFFFF;
+	uint64_t scaled_clk = (uint64_t)PeripheralClock * 1000;  //PCLK * 1000, as FR is scaled by 1000
+	int table_item;
 	
-	upper_bound = 1.9;
-	lower_bound = 1.1;
-	
-	UART_CLK = CLK_FREQ;
-	DLEST = UART_CLK/(16 * baudrate);
-	int_DLEST = DLEST;
-	
-	if(!(DLEST - int_DLEST)){
+	for (table_item = 0; table_item < 72; table_item++) {
 		
-		BAUD_DLEST = int_DLEST;
-		BAUD_DIVADDVAL = 0;
-		BAUD_MULVAL = 1;
-		LPC_UART0-> FDR |= (BAUD_DIVADDVAL <<0) | ( BAUD_MULVAL <<4);
-		LPC_UART0-> DLL |= (BAUD_DLEST & 0xFF);
-		LPC_UART0-> DLM |= ((BAUD_DLEST & 0xFF00)>>8);
-
-	}
-  else {
+		uint32_t FR = Fractional_Divider_Array[table_item][0];
+		uint64_t divisor = (uint64_t)16 * baudrate * FR;
+		uint32_t int_DLEST = (uint32_t)((scaled_clk + divisor / 2) / divisor);
+		uint32_t actual, error;
 		
-	  FR_TABLE_Construct();
-		FREST = 1.5;
-		int_DLEST = DLEST / FREST;
-		FREST = UART_CLK/(16 * baudrate * int_DLEST);
+		//DIVADDVAL > 0 needs DL >= 3
+		if (int_DLEST < (table_item ? 3 : 1) || int_DLEST > 0xFFFF) continue;
 		
-		while(FREST < lower_bound) {
-			
-			table_item ++;
-      FREST	= Fractional_Divider_Array[table_item][0];
-			int_DLEST = UART_CLK/(16 * baudrate * FREST);
-			FREST = UART_CLK/(16 * baudrate * int_DLEST);
-			
-			if(table_item > 71) while(1); //error
-		}
-		
-		while(FREST > upper_bound) {
-			
-			table_item --;
-      FREST	= Fractional_Divider_Array[table_item][0];
-			int_DLEST = UART_CLK/(16 * baudrate * FREST);
-			FREST = UART_CLK/(16 * baudrate * int_DLEST);
-			
-			if(table_item < 0) while(1); //error
+		actual = (uint32_t)(scaled_clk / ((uint64_t)16 * int_DLEST * FR));
+		error = actual > baudrate ? actual - baudrate : baudrate - actual;
+		if (error < best_error) {
+			best_error = error;
+			BAUD_DLEST = int_DLEST;
+			BAUD_DIVADDVAL = Fractional_Divider_Array[table_item][1];
+			BAUD_MULVAL = Fractional_Divider_Array[table_item][2];
 		}
-		
-		BAUD_DIVADDVAL = Fractional_Divider_Array[table_item][1];
-		BAUD_MULVAL = Fractional_Divider_Array[table_item][2];
-		BAUD_DLEST = int_DLEST;
-		
-		LPC_UART0-> FDR |= (BAUD_DIVADDVAL <<0) | ( BAUD_MULVAL <<4);
-		LPC_UART0-> DLM = ((BAUD_DLEST & 0xFF00)>>8);
-		LPC_UART0-> DLL = (BAUD_DLEST & 0x00FF);
-	
 	}
+	if (!BAUD_DLEST) while(1); //error, baudrate out of range
+	
+	LPC_UART0-> FDR = (BAUD_DIVADDVAL <<0) | ( BAUD_MULVAL <<4);
+	LPC_UART0-> DLM = ((BAUD_DLEST & 0xFF00)>>8);
+	LPC_UART0-> DLL = (BAUD_DLEST & 0x00FF);
 	
 }
 
@@ -194,6 +179,16 @@ void uart_tx(uint8_t c) {
 	// and then sends a new byte, c, to the UART peripheral.
 }
 
+int uart_tx_ready(void) {
+	
+	return (LPC_UART0-> LSR & UART_LSR_THRE) != 0;
+}
+
+void uart_tx_fifo(uint8_t c) {
+	
+	LPC_UART0->THR = c & 0xFF;
+}
+
 uint8_t uart_rx(void) {
 	
 	// Blocks until the peripheral has a received character
@@ -203,97 +198,4 @@ uint8_t uart_rx(void) {
   return (LPC_UART0->RBR & 0xFF);
 }
 
-void FR_TABLE_Construct(void){
-	
-	uint32_t i =0;
-	
-	FR_TABLE_Value(Fractional_Divider_Array[i],     1.000,0,1);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.067,1,15);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.071,1,14);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.077,1,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.083,1,12);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.091,1,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.100,1,10);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.111,1,9);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.125,1,8);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.133,2,15);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.143,1,7);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.154,2,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.167,1,6);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.182,2,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.200,1,5);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.214,3,14);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.222,2,9);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.231,3,13);
-	
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.250,1,4);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.267,4,15);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.273,3,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.286,2,7);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.300,3,10);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.308,4,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.333,1,3);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.357,5,14);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.364,4,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.375,3,8);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.385,5,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.400,2,5);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.417,5,12);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.429,3,7);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.444,4,9);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.455,5,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.462,6,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.467,7,15);
-	
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.500,1,2);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.533,8,15);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.538,7,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.545,6,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.556,5,9);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.571,4,7);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.583,7,12);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.600,3,5);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.615,8,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.625,5,8);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.636,7,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.643,9,14);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.667,2,3);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.692,9,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.700,7,10);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.714,5,7);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.727,8,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.733,11,15);
-	
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.750,3,4);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.769,10,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.778,7,9);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.786,11,14);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.800,4,5);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.818,9,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.833,5,6);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.846,11,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.857,6,7);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.867,13,15);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.875,7,8);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.889,8,9);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.900,9,10);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.909,10,11);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.917,11,12);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.923,12,13);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.929,13,14);
-	FR_TABLE_Value(Fractional_Divider_Array[i++],   1.933,14,15);
-
-
-
-
-}
-
-void FR_TABLE_Value(float input_array[3], float FR, float Div, float Mul){
-
-	input_array[0] = FR;
-	input_array[1] = Div;
-	input_array[2] = Mul;
-
-}
-
 // *******************************ARM University Program Copyright © ARM Ltd 2014*************************************   
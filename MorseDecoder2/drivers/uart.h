@@ -7,6 +7,8 @@
 #define UART_H
 #include <stdint.h>
 
+#define UART_FIFO_SIZE 16   //!< Depth of the transmit FIFO.
+
 /*! \brief Initialises the UART controller.
  *  \param baud  Baud rate to be used (symbols per second).
  */
@@ -21,6 +23,20 @@ void uart_enable(void);
  */
 void uart_tx(uint8_t c);
 
+/*! \brief Checks whether the transmit FIFO is empty.
+ *  \return Non-zero if it is, UART_FIFO_SIZE bytes may then be written
+ *          with uart_tx_fifo().
+ */
+int uart_tx_ready(void);
+
+/*! \brief Writes a single character to the transmit FIFO without waiting.
+ *  \warning Only call once uart_tx_ready() has returned non-zero, and at
+ *           most UART_FIFO_SIZE times until it does again; a character
+ *           written to a full FIFO is lost.
+ *  \param c  Character to be sent.
+ */
+void uart_tx_fifo(uint8_t c);
+
 /*! \brief Receive a single character.
  *  \warning This function blocks until a character is
  *           available. For a non-blocking receive, see
@@ -0,0 +1,73 @@
+#include "platform.h"
+#include "comparator.h"
+#include "timebase.h"
+#include "events.h"
+#include "edges.h"
+
+// Only touched by the CMP1 and TIMER3 interrupts, which share a priority
+static int in_mark = 0;
+static uint32_t mark_start = 0;
+static uint32_t last_edge = 0;
+static uint32_t space_reported = 0;     // End of the silence already reported
+static volatile uint32_t poll_us = 0;
+
+// No edge for EDGE_HOLD_US: the mark ended at its last edge
+static void on_hold(void) {
+    in_mark = 0;
+    events_push(0, 1, last_edge - mark_start);
+    space_reported = last_edge;
+}
+
+// Reports the silence so far and polls again
+static void on_poll(void) {
+    uint32_t now = timebase_now_us();
+
+    if (!in_mark) {
+        events_push(0, 0, now - space_reported);
+        space_reported = now;
+    }
+    if (poll_us) timebase_alarm(AlarmEdgePoll, now + poll_us, on_poll);
+}
+
+// Comparator edge: starts a mark after silence and pushes the hold
+// timeout out by EDGE_HOLD_US.
+static void on_edge(int state) {
+    uint32_t now = timebase_now_us();
+    (void)state;
+
+    if (!in_mark) {
+        events_push(0, 0, now - space_reported);
+        mark_start = now;
+        in_mark = 1;
+    }
+    last_edge = now;
+    timebase_alarm(AlarmEdgeHold, now + EDGE_HOLD_US, on_hold);
+}
+
+void edges_init(void) {
+    comparator_init();
+    timebase_init();
+}
+
+void edges_start(void) {
+    in_mark = 0;
+    space_reported = timebase_now_us();
+    comparator_set_trigger(CompBoth);
+    comparator_set_callback(on_edge);  // Enables the interrupt again after edges_stop()
+}
+
+void edges_stop(void) {
+    comparator_set_trigger(CompNone);
+    timebase_cancel(AlarmEdgeHold);
+    timebase_cancel(AlarmEdgePoll);
+}
+
+void edges_poll_space(uint32_t us) {
+    if (us == poll_us) return;
+
+    // A running poll picks up the new period when it next fires
+    if (us != 0 && poll_us == 0) {
+        timebase_alarm(AlarmEdgePoll, timebase_now_us() + us, on_poll);
+    }
+    poll_us = us;
+}
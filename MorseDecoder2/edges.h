@@ -0,0 +1,30 @@
+#ifndef EDGES_H
+#define EDGES_H
+
+#include <stdint.h>
+
+#define EDGE_HOLD_US 5000   // A mark ends this long after its last edge, covers tones down to 200 Hz
+
+/**
+ * @brief Sets up CMP1 edge interrupts and the timebase.
+ *
+ * Every comparator edge is timestamped from the microsecond timebase. A
+ * mark starts at the first edge after silence and ends once no edge has
+ * arrived for EDGE_HOLD_US, which a timebase alarm detects without any
+ * polling. Both are reported as events (see events.h).
+ */
+void edges_init(void);
+
+/** @brief Enables the comparator interrupt and starts timestamping. */
+void edges_start(void);
+
+/** @brief Disables the comparator interrupt. */
+void edges_stop(void);
+
+/**
+ * @brief Reports silence in progress every @p us, so that a decoder
+ *        sleeping in __WFI() sees gaps as they grow. 0 stops reporting.
+ */
+void edges_poll_space(uint32_t us);
+
+#endif // EDGES_H
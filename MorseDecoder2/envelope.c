@@ -0,0 +1,24 @@
+#include "envelope.h"
+
+#define ENVELOPE_MASK  (ENVELOPE_WINDOW - 1)
+#define ENVELOPE_SHIFT 5    // log2(ENVELOPE_WINDOW)
+
+void envelope_init(Envelope *env) {
+    for (int i = 0; i < ENVELOPE_WINDOW; i++) {
+        env->history[i] = 0;
+    }
+    env->sum = 0;
+    env->index = 0;
+}
+
+q15_t envelope_update(Envelope *env, int32_t rectified) {
+    env->sum += rectified - env->history[env->index];
+    env->history[env->index] = (uint16_t)rectified;
+    env->index = (env->index + 1) & ENVELOPE_MASK;
+    return envelope_get(env);
+}
+
+q15_t envelope_get(const Envelope *env) {
+    // At most 32768 when every sample is -1.0, so saturate
+    return (q15_t)__SSAT((int32_t)(env->sum >> ENVELOPE_SHIFT), 16);
+}
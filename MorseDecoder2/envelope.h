@@ -0,0 +1,31 @@
+#ifndef ENVELOPE_H
+#define ENVELOPE_H
+
+#include <stdint.h>
+#include "fixed.h"          // q15_t
+
+#define ENVELOPE_WINDOW 32  // Samples, power of two (4 ms at 8 kHz)
+
+/** Sliding window mean of a rectified Q15 signal. */
+typedef struct {
+    uint16_t history[ENVELOPE_WINDOW];
+    uint32_t sum;
+    int index;
+} Envelope;
+
+/** @brief Empties the window. */
+void envelope_init(Envelope *env);
+
+/**
+ * @brief Adds one sample to the window in O(1): the oldest sample
+ *        leaves the running sum as the new one enters.
+ * @param env       Envelope state.
+ * @param rectified Q15 magnitude of the sample, 0 to 32768.
+ * @return Current envelope, as envelope_get().
+ */
+q15_t envelope_update(Envelope *env, int32_t rectified);
+
+/** @brief Q15 mean of the last ENVELOPE_WINDOW samples. */
+q15_t envelope_get(const Envelope *env);
+
+#endif // ENVELOPE_H
@@ -0,0 +1,41 @@
+#include "platform.h"
+#include "events.h"
+
+// Single producer, single consumer: head is only written by the front
+// end, tail only by the decoder
+static MorseEvent event_queue[EVENT_QUEUE_SIZE];
+static volatile unsigned int event_head = 0;
+static volatile unsigned int event_tail = 0;
+static volatile uint32_t overruns = 0;
+static void (*event_notify)(void) = 0;
+
+int events_push(int channel, int mark, uint32_t duration_us) {
+    if (event_head - event_tail >= EVENT_QUEUE_SIZE) {
+        overruns++;
+        return 0;
+    }
+    MorseEvent *event = &event_queue[event_head % EVENT_QUEUE_SIZE];
+    event->channel = channel;
+    event->mark = mark;
+    event->duration_us = duration_us;
+    __DMB();                // Event written before it is published
+    event_head++;
+    if (event_notify) event_notify();
+    return 1;
+}
+
+int events_pop(MorseEvent *event) {
+    if (event_tail == event_head) return 0;
+    __DMB();                // Head read before the event it publishes
+    *event = event_queue[event_tail % EVENT_QUEUE_SIZE];
+    event_tail++;
+    return 1;
+}
+
+void events_set_notify(void (*notify)(void)) {
+    event_notify = notify;
+}
+
+uint32_t events_overruns(void) {
+    return overruns;
+}
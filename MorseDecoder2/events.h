@@ -0,0 +1,44 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdint.h>
+
+#define EVENT_QUEUE_SIZE 128 // Power of two, room for a few blocks of every channel
+
+/**
+ * One stretch of tone or silence, timed by the front end from its own
+ * hardware clock. A front end may split a long stretch into several
+ * consecutive events of the same kind, e.g. to report a gap while it is
+ * still growing; the decoder adds them up.
+ */
+typedef struct {
+    uint32_t duration_us;
+    uint8_t mark;           // 1 for tone, 0 for silence
+    uint8_t channel;        // Signal the event belongs to, 0 for a single one
+} MorseEvent;
+
+/**
+ * @brief Queues an event. Called by the front end, normally from its
+ *        interrupts; producers must not preempt each other.
+ * @return 1 if queued, 0 if the queue was full and the event was dropped.
+ */
+int events_push(int channel, int mark, uint32_t duration_us);
+
+/**
+ * @brief Takes the oldest event.
+ * @param event Filled in if one was available.
+ * @return 1 if an event was taken, 0 if none is pending.
+ */
+int events_pop(MorseEvent *event);
+
+/**
+ * @brief Registers a function that events_push() calls after queueing an
+ *        event, in the producer's context, e.g. to wake the consumer.
+ * @param notify Called for every queued event, 0 for none.
+ */
+void events_set_notify(void (*notify)(void));
+
+/** @brief Number of events dropped because the queue was full. */
+uint32_t events_overruns(void);
+
+#endif // EVENTS_H
@@ -0,0 +1,32 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+#include "arm_math.h"       // q15_t, q31_t and __SSAT()
+#include "platform.h"       // ADC_BITS
+
+/*
+ * Fixed-point formats of the signal path, from ADC to decision:
+ *
+ *   samples, band-pass output   Q15, ADC full scale around the midpoint = 1.0
+ *   envelope, ENV thresholds    Q15, mean of |sample|
+ *   Goertzel coefficients       Q14, 2*cos(w)
+ *   tone power, TONE thresholds Q30, a Q15 amplitude squared
+ *
+ * Every stage saturates instead of wrapping; nothing on the per-sample
+ * path uses floats or 64-bit division.
+ */
+
+// Left shift from a midpoint-centred ADC sample to Q15
+#define ADC_Q15_SHIFT  (16 - ADC_BITS)
+
+/** Centres a raw ADC result on @p mid and converts it to saturated Q15. */
+#define Q15_FROM_ADC(raw, mid)  ((q15_t)__SSAT(((int32_t)(raw) - (int32_t)(mid)) << ADC_Q15_SHIFT, 16))
+
+/** Q15 value of an amplitude given in ADC counts. */
+#define Q15_FROM_COUNTS(c)      ((q15_t)((c) << ADC_Q15_SHIFT))
+
+/** Q30 power of a sine with an amplitude given in ADC counts. */
+#define Q30_FROM_COUNTS(c)      ((uint32_t)Q15_FROM_COUNTS(c) * (uint32_t)Q15_FROM_COUNTS(c))
+
+#endif // FIXED_H
@@ -0,0 +1,66 @@
+#include "platform.h"
+#include "timer.h"
+#include "timebase.h"
+#include "freqmeter.h"
+
+#define MIN_PERIOD (PeripheralClock / FREQMETER_MAX_HZ)
+#define MAX_PERIOD (PeripheralClock / FREQMETER_MIN_HZ)
+
+#if FREQMETER_TIMEOUT_MS * FREQMETER_MIN_HZ <= 1000
+#error "FREQMETER_TIMEOUT_MS must outlast the longest valid period"
+#endif
+
+static uint32_t last_capture = 0;
+static uint32_t period_sum = 0;
+static int periods = 0;
+
+// Published by the capture interrupt, average period in timer counts
+static volatile uint32_t average_period = 0;
+static volatile uint32_t valid_at = 0;      // Timebase at the last valid period
+
+// Capture interrupt: one rising edge of the tone
+static void on_capture(uint32_t count) {
+    uint32_t period = count - last_capture;
+    last_capture = count;
+
+    // A glitch or the first edge after silence restarts the average
+    if (period < MIN_PERIOD || period > MAX_PERIOD) {
+        period_sum = 0;
+        periods = 0;
+        return;
+    }
+
+    valid_at = timebase_now_us();
+    period_sum += period;
+    if (++periods == FREQMETER_AVERAGE) {
+        average_period = period_sum / FREQMETER_AVERAGE;
+        period_sum = 0;
+        periods = 0;
+    }
+}
+
+void freqmeter_init(void) {
+    timebase_init();
+    timer_capture_init();
+    timer_capture_set_callback(on_capture);
+    timer_capture_enable();
+}
+
+int freqmeter_hz(void) {
+    uint32_t period, at;
+
+    // A published value goes stale once no valid period has come for
+    // FREQMETER_TIMEOUT_MS, however long the average takes to publish;
+    // dropping it here also keeps the comparison valid when the timebase
+    // wraps
+    __disable_irq();
+    period = average_period;
+    at = valid_at;
+    if (period != 0 && timebase_now_us() - at > FREQMETER_TIMEOUT_MS * 1000) {
+        average_period = period = 0;
+    }
+    __enable_irq();
+
+    if (period == 0) return 0;
+    return (PeripheralClock + period / 2) / period;
+}
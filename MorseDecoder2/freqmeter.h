@@ -0,0 +1,28 @@
+#ifndef FREQMETER_H
+#define FREQMETER_H
+
+#include <stdint.h>
+
+#define FREQMETER_AVERAGE    16     // Periods per published measurement
+#define FREQMETER_MIN_HZ     200    // Periods outside this range are glitches
+#define FREQMETER_MAX_HZ     1200
+#define FREQMETER_TIMEOUT_MS 20     // No valid period this long: no tone
+
+/**
+ * @brief Starts measuring the tone on P_CAP.
+ *
+ * TIMER1 captures every rising edge of the squared-up tone (for example
+ * the CMP1 output wired to P_CAP), the capture interrupt averages
+ * FREQMETER_AVERAGE periods and publishes the result. No ADC sample or
+ * DSP cycle is involved. TIMER1 is owned by the meter from here on.
+ */
+void freqmeter_init(void);
+
+/**
+ * @brief Latest averaged tone frequency.
+ * @return Frequency in Hz, 0 if no tone has been measured for
+ *         FREQMETER_TIMEOUT_MS.
+ */
+int freqmeter_hz(void);
+
+#endif // FREQMETER_H
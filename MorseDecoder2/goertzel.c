@@ -0,0 +1,79 @@
+#include "goertzel.h"
+
+#define GOERTZEL_Q 14
+
+// 2*cos(2*pi*f/8000) * 2^14 for f = 300, 350, ... 800 Hz
+const int16_t goertzel_coeff[GOERTZEL_BINS] = {
+    31863, 31538, 31164, 30743, 30274, 29758,
+    29197, 28590, 27939, 27246, 26510
+};
+
+// Scales raw |X|^2 back to the input amplitude, see goertzel_bank_process().
+// Dividing by (n/2)^2 is a shift because n is a power of two.
+static uint32_t goertzel_finish(int32_t s1, int32_t s2, int16_t coeff, int n) {
+    int64_t power = (int64_t)s1 * s1 + (int64_t)s2 * s2
+                  - (((int64_t)coeff * s1) >> GOERTZEL_Q) * s2;
+    int shift = 0;
+
+    if (power < 0) power = 0;
+    while ((2 << shift) < n) shift++;
+    power >>= 2 * shift;
+
+    return power > UINT32_MAX ? UINT32_MAX : (uint32_t)power;
+}
+
+void goertzel_bank_init(GoertzelBank *bank) {
+    for (int b = 0; b < GOERTZEL_BINS; b++) {
+        bank->power[b] = 0;
+    }
+    bank->strongest = 0;
+    bank->locked = -1;
+    bank->candidate = -1;
+    bank->votes = 0;
+}
+
+void goertzel_bank_process(GoertzelBank *bank, const q15_t *x, int n, uint32_t min_power) {
+    int32_t s1[GOERTZEL_BINS] = {0};
+    int32_t s2[GOERTZEL_BINS] = {0};
+
+    // Each sample is loaded once and fed to every bin
+    for (int i = 0; i < n; i++) {
+        int32_t sample = x[i];
+        for (int b = 0; b < GOERTZEL_BINS; b++) {
+            int32_t s0 = sample + (int32_t)(((int64_t)goertzel_coeff[b] * s1[b]) >> GOERTZEL_Q) - s2[b];
+            s2[b] = s1[b];
+            s1[b] = s0;
+        }
+    }
+
+    int strongest = 0;
+    for (int b = 0; b < GOERTZEL_BINS; b++) {
+        bank->power[b] = goertzel_finish(s1[b], s2[b], goertzel_coeff[b], n);
+        if (bank->power[b] > bank->power[strongest]) strongest = b;
+    }
+    bank->strongest = strongest;
+
+    // Silence neither confirms nor breaks the lock
+    if (bank->power[strongest] <= min_power) return;
+
+    if (strongest == bank->locked) {
+        bank->votes = 0;
+        return;
+    }
+    if (strongest == bank->candidate) {
+        bank->votes++;
+    } else {
+        bank->candidate = strongest;
+        bank->votes = 1;
+    }
+    if (bank->votes >= GOERTZEL_LOCK_BLOCKS) {
+        bank->locked = strongest;
+        bank->candidate = -1;
+        bank->votes = 0;
+    }
+}
+
+uint32_t goertzel_bank_tone_power(const GoertzelBank *bank) {
+    if (bank->locked < 0) return bank->power[bank->strongest];
+    return bank->power[bank->locked];
+}
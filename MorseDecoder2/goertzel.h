@@ -0,0 +1,58 @@
+#ifndef GOERTZEL_H
+#define GOERTZEL_H
+
+#include <stdint.h>
+#include "fixed.h"          // q15_t
+
+// Coefficient table layout: bins from GOERTZEL_F_MIN to GOERTZEL_F_MAX
+// in GOERTZEL_F_STEP steps, computed for a GOERTZEL_FS sampling rate.
+#define GOERTZEL_FS      8000
+#define GOERTZEL_F_MIN   300
+#define GOERTZEL_F_MAX   800
+#define GOERTZEL_F_STEP  50
+#define GOERTZEL_BINS    ((GOERTZEL_F_MAX - GOERTZEL_F_MIN) / GOERTZEL_F_STEP + 1)
+
+// Table index of a frequency in Hz
+#define GOERTZEL_BIN(f)  (((f) - GOERTZEL_F_MIN) / GOERTZEL_F_STEP)
+
+/** Q14 coefficients 2*cos(2*pi*f/GOERTZEL_FS), one per bin. */
+extern const int16_t goertzel_coeff[GOERTZEL_BINS];
+
+// Consecutive blocks a bin must win before the bank locks onto it
+#define GOERTZEL_LOCK_BLOCKS 3
+
+/** Filter bank covering every bin of goertzel_coeff. */
+typedef struct {
+    uint32_t power[GOERTZEL_BINS];  // Per-bin Q30 power of the last block
+    int strongest;                  // Bin with the highest power in the last block
+    int locked;                     // Bin being tracked, -1 while searching
+    int candidate;                  // Bin currently collecting votes
+    int votes;
+} GoertzelBank;
+
+/** @brief Clears the bank and starts searching for a tone. */
+void goertzel_bank_init(GoertzelBank *bank);
+
+/**
+ * @brief Evaluates all bins in one pass over a block and updates the lock.
+ *
+ * Bin powers are normalised so that a sine of Q15 amplitude A, centred on
+ * a bin, gives a Q30 power of about A*A whatever the block length.
+ *
+ * A bin becomes locked after winning GOERTZEL_LOCK_BLOCKS blocks in a row
+ * with more than @p min_power; a locked bin is only replaced the same way.
+ *
+ * @param bank      Bank state.
+ * @param x         Q15 samples with the DC offset removed.
+ * @param n         Number of samples, a power of two.
+ * @param min_power Q30 power a block needs to count as a vote.
+ */
+void goertzel_bank_process(GoertzelBank *bank, const q15_t *x, int n, uint32_t min_power);
+
+/**
+ * @brief Tone power used for detection: the locked bin once locked,
+ *        otherwise the strongest bin.
+ */
+uint32_t goertzel_bank_tone_power(const GoertzelBank *bank);
+
+#endif // GOERTZEL_H
@@ -0,0 +1,53 @@
+#include "platform.h"
+#include "gpio.h"
+#include "comparator.h"
+#include "power.h"          // Sleep and Deep-sleep
+#include "timebase.h"       // Wake-up timestamp
+#include "idle.h"
+
+static volatile int woken = 0;
+static volatile uint32_t woken_at = 0;
+
+static void on_wake(void) {
+    if (!woken) {
+        woken_at = timebase_now_us();
+        woken = 1;
+    }
+}
+
+static void on_comparator(int state) {
+    (void)state;
+    on_wake();
+}
+
+static void on_switch(int status) {
+    (void)status;
+    on_wake();
+}
+
+void idle_init(void) {
+    timebase_init();
+    comparator_init();
+    comparator_set_trigger(CompNone);
+    gpio_set_mode(P_SW, PullUp);
+    gpio_set_trigger(P_SW, None);
+    gpio_set_callback(P_SW, on_switch);
+}
+
+uint32_t idle_sleep(void) {
+    uint32_t restore_us = 0;
+
+    woken = 0;
+    comparator_set_trigger(CompBoth);
+    comparator_set_callback(on_comparator);
+    gpio_set_trigger(P_SW, Falling);
+
+    // Other interrupts end Sleep as well, only a wake-up source ends idle
+    while (!woken) {
+        restore_us = power_sleep(IDLE_DEEP_SLEEP ? PowerDeepSleep : PowerSleep);
+    }
+
+    comparator_set_trigger(CompNone);
+    gpio_set_trigger(P_SW, None);
+    return woken_at - restore_us;
+}
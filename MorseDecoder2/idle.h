@@ -0,0 +1,24 @@
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stdint.h>
+
+#define IDLE_DEEP_SLEEP 1   // 1: Deep-sleep, 0: Sleep, which keeps every clock running and wakes sooner
+
+/**
+ * @brief Sets up the wake-up sources: a CMP1 edge, the input going to
+ *        P_CMP_PLUS as for edges.c, and a press of P_SW. Owns the
+ *        comparator, so it cannot be used together with edges.c.
+ */
+void idle_init(void);
+
+/**
+ * @brief Sleeps until a wake-up source fires. The caller stops its front
+ *        end, and powers down what it can, before, and restarts it after.
+ * @return Time of the wake-up as timebase_now_us(), moved back by the
+ *         time spent restoring the clocks, so that the wake-up latency of
+ *         any later step is timebase_now_us() minus it.
+ */
+uint32_t idle_sleep(void);
+
+#endif // IDLE_H
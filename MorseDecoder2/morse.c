@@ -0,0 +1,118 @@
+#include <stdint.h>
+#include "morse.h"
+
+// Elements of a code, first element first
+#define DIT 0
+#define DAH 1
+
+// Tree node of a code: the elements shifted in below a leading 1 bit
+#define MORSE_1(a)                  (2 | (a))
+#define MORSE_2(a, b)               ((MORSE_1(a) << 1) | (b))
+#define MORSE_3(a, b, c)            ((MORSE_2(a, b) << 1) | (c))
+#define MORSE_4(a, b, c, d)         ((MORSE_3(a, b, c) << 1) | (d))
+#define MORSE_5(a, b, c, d, e)      ((MORSE_4(a, b, c, d) << 1) | (e))
+#define MORSE_6(a, b, c, d, e, f)   ((MORSE_5(a, b, c, d, e) << 1) | (f))
+
+// The one list of characters and codes. Both tables below are generated
+// from it by the compiler, so they are const data in flash with nothing
+// to set up at run time.
+#define MORSE_CODES(X) \
+    X('A',  MORSE_2(DIT, DAH)) \
+    X('B',  MORSE_4(DAH, DIT, DIT, DIT)) \
+    X('C',  MORSE_4(DAH, DIT, DAH, DIT)) \
+    X('D',  MORSE_3(DAH, DIT, DIT)) \
+    X('E',  MORSE_1(DIT)) \
+    X('F',  MORSE_4(DIT, DIT, DAH, DIT)) \
+    X('G',  MORSE_3(DAH, DAH, DIT)) \
+    X('H',  MORSE_4(DIT, DIT, DIT, DIT)) \
+    X('I',  MORSE_2(DIT, DIT)) \
+    X('J',  MORSE_4(DIT, DAH, DAH, DAH)) \
+    X('K',  MORSE_3(DAH, DIT, DAH)) \
+    X('L',  MORSE_4(DIT, DAH, DIT, DIT)) \
+    X('M',  MORSE_2(DAH, DAH)) \
+    X('N',  MORSE_2(DAH, DIT)) \
+    X('O',  MORSE_3(DAH, DAH, DAH)) \
+    X('P',  MORSE_4(DIT, DAH, DAH, DIT)) \
+    X('Q',  MORSE_4(DAH, DAH, DIT, DAH)) \
+    X('R',  MORSE_3(DIT, DAH, DIT)) \
+    X('S',  MORSE_3(DIT, DIT, DIT)) \
+    X('T',  MORSE_1(DAH)) \
+    X('U',  MORSE_3(DIT, DIT, DAH)) \
+    X('V',  MORSE_4(DIT, DIT, DIT, DAH)) \
+    X('W',  MORSE_3(DIT, DAH, DAH)) \
+    X('X',  MORSE_4(DAH, DIT, DIT, DAH)) \
+    X('Y',  MORSE_4(DAH, DIT, DAH, DAH)) \
+    X('Z',  MORSE_4(DAH, DAH, DIT, DIT)) \
+    X('1',  MORSE_5(DIT, DAH, DAH, DAH, DAH)) \
+    X('2',  MORSE_5(DIT, DIT, DAH, DAH, DAH)) \
+    X('3',  MORSE_5(DIT, DIT, DIT, DAH, DAH)) \
+    X('4',  MORSE_5(DIT, DIT, DIT, DIT, DAH)) \
+    X('5',  MORSE_5(DIT, DIT, DIT, DIT, DIT)) \
+    X('6',  MORSE_5(DAH, DIT, DIT, DIT, DIT)) \
+    X('7',  MORSE_5(DAH, DAH, DIT, DIT, DIT)) \
+    X('8',  MORSE_5(DAH, DAH, DAH, DIT, DIT)) \
+    X('9',  MORSE_5(DAH, DAH, DAH, DAH, DIT)) \
+    X('0',  MORSE_5(DAH, DAH, DAH, DAH, DAH)) \
+    X('.',  MORSE_6(DIT, DAH, DIT, DAH, DIT, DAH)) \
+    X(',',  MORSE_6(DAH, DAH, DIT, DIT, DAH, DAH)) \
+    X(':',  MORSE_6(DAH, DAH, DAH, DIT, DIT, DIT)) \
+    X('?',  MORSE_6(DIT, DIT, DAH, DAH, DIT, DIT)) \
+    X('\'', MORSE_6(DIT, DAH, DAH, DAH, DAH, DIT)) \
+    X('-',  MORSE_6(DAH, DIT, DIT, DIT, DIT, DAH)) \
+    X('/',  MORSE_5(DAH, DIT, DIT, DAH, DIT)) \
+    X('(',  MORSE_5(DAH, DIT, DAH, DAH, DIT)) \
+    X(')',  MORSE_6(DAH, DIT, DAH, DAH, DIT, DAH)) \
+    X('"',  MORSE_6(DIT, DAH, DIT, DIT, DAH, DIT)) \
+    X('=',  MORSE_5(DAH, DIT, DIT, DIT, DAH)) \
+    X('+',  MORSE_5(DIT, DAH, DIT, DAH, DIT)) \
+    X('!',  MORSE_6(DIT, DIT, DIT, DAH, DIT, DAH)) \
+    X('~',  MORSE_5(DIT, DAH, DIT, DIT, DIT)) \
+    X('_',  MORSE_5(DIT, DIT, DIT, DAH, DIT)) \
+    X('@',  MORSE_6(DIT, DAH, DAH, DIT, DAH, DIT))
+
+// Decode tree, indexed by node; 0 where no character is assigned
+#define TREE_ENTRY(c, node)  [node] = (c),
+static const char morse_tree[MORSE_TREE_SIZE] = { MORSE_CODES(TREE_ENTRY) };
+
+// Encode table, indexed by ASCII character; MORSE_INVALID if none
+#define CODE_ENTRY(c, node)  [(unsigned char)(c)] = (node),
+static const uint8_t morse_codes[128] = { MORSE_CODES(CODE_ENTRY) };
+
+// Never called. Two characters with the same code, or one character
+// listed twice, give duplicate case labels and the build fails.
+#define CASE_NODE(c, node)   case (node):
+#define CASE_CHAR(c, node)   case (c):
+static inline void morse_check_unique(int node, char c) {
+    switch (node) { MORSE_CODES(CASE_NODE) break; }
+    switch (c) { MORSE_CODES(CASE_CHAR) break; }
+}
+
+int morse_step(int node, int dash) {
+    if (node == MORSE_INVALID) return MORSE_INVALID;
+    node = 2 * node + (dash != 0);
+    return node < MORSE_TREE_SIZE ? node : MORSE_INVALID;
+}
+
+char morse_char(int node) {
+    char c = morse_tree[node];
+    return c ? c : '#';
+}
+
+int morse_encode(char c) {
+    if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    if ((unsigned char)c >= sizeof(morse_codes)) return MORSE_INVALID;
+    return morse_codes[(unsigned char)c];
+}
+
+int morse_format(int node, char *text) {
+    int length = 0;
+    int n = 0;
+
+    // The highest set bit is the root, the bits below it the elements
+    while ((node >> (length + 1)) != 0) length++;
+    for (int i = length - 1; i >= 0; i--) {
+        text[n++] = (node >> i) & 1 ? '-' : '.';
+    }
+    text[n] = '\0';
+    return n;
+}
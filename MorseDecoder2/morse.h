@@ -0,0 +1,42 @@
+#ifndef MORSE_H
+#define MORSE_H
+
+// Morse codes as a binary tree stored heap-style: the empty code is node
+// MORSE_ROOT, a dot moves from node i to 2i and a dash to 2i + 1. A code
+// is resolved by walking one step per element as it is received.
+#define MORSE_ROOT         1
+#define MORSE_INVALID      0    // Code longer than any in the table
+#define MORSE_MAX_ELEMENTS 6
+#define MORSE_TREE_SIZE    (2 << MORSE_MAX_ELEMENTS)
+
+/**
+ * @brief Advances a code by one element.
+ * @param node Node reached so far, MORSE_ROOT for a new code.
+ * @param dash 1 for a dash, 0 for a dot.
+ * @return Child node, MORSE_INVALID once the code is too long.
+ */
+int morse_step(int node, int dash);
+
+/**
+ * @brief Character of a complete code.
+ * @param node Node reached by the code.
+ * @return The character, '#' for codes that have none.
+ */
+char morse_char(int node);
+
+/**
+ * @brief Code of a character, for transmitting.
+ * @param c Character, letters in either case.
+ * @return Its tree node, MORSE_INVALID if it has no code.
+ */
+int morse_encode(char c);
+
+/**
+ * @brief Writes a code as '.' and '-' characters, for display only.
+ * @param node Node reached by the code.
+ * @param text Room for MORSE_MAX_ELEMENTS + 1 characters.
+ * @return Number of elements written before the terminating '\0'.
+ */
+int morse_format(int node, char *text);
+
+#endif // MORSE_H
@@ -0,0 +1,65 @@
+#include "noise.h"
+
+// Thresholds relative to the noise floor
+#define TONE_FLOOR_RATIO   8    // About 9 dB above the idle tone power
+#define ENV_ON_RATIO       3
+#define ENV_OFF_RATIO      2
+
+// Lower limits for a perfectly quiet input
+#define TONE_MIN_POWER     Q30_FROM_COUNTS(20)
+#define ENV_MIN_ON         Q15_FROM_COUNTS(12)
+#define ENV_MIN_OFF        Q15_FROM_COUNTS(8)
+
+// Moves an estimate towards a new block value: a plain running mean while
+// calibrating, an exponential average with a 2^shift block time constant after.
+static int32_t track(int32_t estimate, int32_t value, int blocks, int shift) {
+    if (blocks < NOISE_CAL_BLOCKS) {
+        return estimate + (value - estimate) / (blocks + 1);
+    }
+    return estimate + ((value - estimate) >> shift);
+}
+
+void noise_init(NoiseTracker *nt) {
+    nt->midpoint = (ADC_MASK / 2 + 1) << NOISE_TRACK_SHIFT;
+    nt->env_floor = 0;
+    nt->power_floor = 0;
+    nt->blocks = 0;
+}
+
+int noise_calibrating(const NoiseTracker *nt) {
+    return nt->blocks < NOISE_CAL_BLOCKS;
+}
+
+void noise_update(NoiseTracker *nt, int raw_mean, q15_t env_mean, uint32_t power, int idle) {
+    if (!noise_calibrating(nt) && !idle) return;
+
+    nt->midpoint = track(nt->midpoint, raw_mean << NOISE_TRACK_SHIFT, nt->blocks, NOISE_TRACK_SHIFT);
+    nt->env_floor = track(nt->env_floor, env_mean << NOISE_TRACK_SHIFT, nt->blocks, NOISE_TRACK_SHIFT);
+    // Q30 values stay below 2^31, so their difference fits an int32_t
+    nt->power_floor = track(nt->power_floor, (int32_t)(power >> 1), nt->blocks, NOISE_TRACK_SHIFT);
+
+    if (nt->blocks < NOISE_CAL_BLOCKS) nt->blocks++;
+}
+
+int noise_midpoint(const NoiseTracker *nt) {
+    return nt->midpoint >> NOISE_TRACK_SHIFT;
+}
+
+uint32_t noise_tone_threshold(const NoiseTracker *nt) {
+    // power_floor holds half the power, see noise_update()
+    uint32_t threshold = (uint32_t)nt->power_floor * (2 * TONE_FLOOR_RATIO);
+    if (nt->power_floor > (int32_t)(UINT32_MAX / (2 * TONE_FLOOR_RATIO))) threshold = UINT32_MAX;
+    return threshold > TONE_MIN_POWER ? threshold : TONE_MIN_POWER;
+}
+
+q15_t noise_env_on(const NoiseTracker *nt) {
+    int32_t on = (nt->env_floor >> NOISE_TRACK_SHIFT) * ENV_ON_RATIO;
+    if (on < ENV_MIN_ON) on = ENV_MIN_ON;
+    return (q15_t)__SSAT(on, 16);
+}
+
+q15_t noise_env_off(const NoiseTracker *nt) {
+    int32_t off = (nt->env_floor >> NOISE_TRACK_SHIFT) * ENV_OFF_RATIO;
+    if (off < ENV_MIN_OFF) off = ENV_MIN_OFF;
+    return (q15_t)__SSAT(off, 16);
+}
@@ -0,0 +1,51 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+#include <stdint.h>
+#include "fixed.h"          // q15_t
+
+#define NOISE_CAL_BLOCKS   16   // Startup calibration, 256 ms at 16 ms per block
+#define NOISE_TRACK_SHIFT  4    // Idle tracking time constant, 2^4 blocks
+
+/** DC midpoint and noise floor of the input, with the thresholds derived from them. */
+typedef struct {
+    int32_t midpoint;       // ADC counts << NOISE_TRACK_SHIFT
+    int32_t env_floor;      // Q15 idle envelope << NOISE_TRACK_SHIFT
+    int32_t power_floor;    // Q30 idle tone power
+    int blocks;             // Blocks seen, saturates at NOISE_CAL_BLOCKS
+} NoiseTracker;
+
+/** @brief Starts a new calibration from nominal mid-scale values. */
+void noise_init(NoiseTracker *nt);
+
+/** @brief Non-zero until NOISE_CAL_BLOCKS blocks have been measured. */
+int noise_calibrating(const NoiseTracker *nt);
+
+/**
+ * @brief Feeds the statistics of one block.
+ *
+ * During calibration every block is averaged in, so the input must be idle
+ * for the first NOISE_CAL_BLOCKS blocks. Afterwards only blocks with
+ * @p idle set move the estimates, through an exponential average.
+ *
+ * @param nt       Tracker state.
+ * @param raw_mean Mean raw ADC result of the block.
+ * @param env_mean Q15 mean envelope of the block.
+ * @param power    Q30 tone power of the block.
+ * @param idle     Non-zero if no tone was present.
+ */
+void noise_update(NoiseTracker *nt, int raw_mean, q15_t env_mean, uint32_t power, int idle);
+
+/** @brief DC midpoint in ADC counts, for Q15_FROM_ADC(). */
+int noise_midpoint(const NoiseTracker *nt);
+
+/** @brief Q30 tone power above which a block holds a tone. */
+uint32_t noise_tone_threshold(const NoiseTracker *nt);
+
+/** @brief Q15 envelope at which a mark starts. */
+q15_t noise_env_on(const NoiseTracker *nt);
+
+/** @brief Q15 envelope below which a mark ends. */
+q15_t noise_env_off(const NoiseTracker *nt);
+
+#endif // NOISE_H
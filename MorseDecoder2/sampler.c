@@ -0,0 +1,90 @@
+#include "platform.h"
+#include "adc.h"
+#include "dma.h"
+#include "sampler.h"
+
+//PCONP power control register
+#define PCTIM0                (1UL << 1)
+
+//MCR: reset the counter on MR1
+#define TIM_MCR_RESET_MR1     (1UL << 4)
+//EMR: toggle MAT0.1 on match
+#define TIM_EMR_TOGGLE_MAT1   (3UL << 6)
+
+static uint32_t sample_buffer[2][DMA_BUFFER_SIZE];
+static DmaLLI sample_lli[2];
+static volatile int ping_pong = PING;
+
+static void (*block_callback)(const uint32_t *block, int length);
+
+static void sampler_dma_handler(void) {
+
+	int done;
+
+	if (!dma_state(SAMPLER_DMA_CHANNEL)) return;
+	dma_clean(SAMPLER_DMA_CHANNEL);
+
+	//The controller has already moved on to the other buffer
+	done = ping_pong;
+	ping_pong ^= 1;
+
+	if (block_callback) block_callback(sample_buffer[done], DMA_BUFFER_SIZE);
+}
+
+void sampler_init(uint32_t rate) {
+
+	unsigned int control = dma_control(DMA_BUFFER_SIZE, DMA_BURST_1, DMA_WIDTH_WORD, DMA_P2M);
+	int i;
+
+	adc_init();
+	dma_init();
+
+	//Circular list: PING -> PONG -> PING
+	for (i = PING; i <= PONG; i++) {
+		sample_lli[i].SrcAddr = adc_data_address();
+		sample_lli[i].DstAddr = (unsigned int)sample_buffer[i];
+		sample_lli[i].NextLLI = (unsigned int)&sample_lli[i ^ 1];
+		sample_lli[i].Control = control;
+	}
+
+	dma_set_callback(sampler_dma_handler);
+
+	//TIMER0 counts PCLK and toggles MAT0.1 twice per sample period
+	LPC_SC -> PCONP |= PCTIM0;
+	LPC_TIM0 -> TCR = 0;
+	LPC_TIM0 -> CTCR = 0;
+	LPC_TIM0 -> PR = 0;
+	LPC_TIM0 -> MR1 = PeripheralClock / (2 * rate) - 1;
+	LPC_TIM0 -> MCR = TIM_MCR_RESET_MR1;
+	LPC_TIM0 -> EMR = TIM_EMR_TOGGLE_MAT1;
+	LPC_TIM0 -> TCR |= (1<<1);  //Reset Counter
+	LPC_TIM0 -> TCR &= ~(1<<1); //release reset
+}
+
+void sampler_set_callback(void (*callback)(const uint32_t *block, int length)) {
+
+	block_callback = callback;
+}
+
+void sampler_start(void) {
+
+	//Restart from the first buffer, a stopped channel may be mid-block
+	dma_setup(SAMPLER_DMA_CHANNEL,
+						adc_data_address(), (unsigned int)sample_buffer[PING],
+						DMA_REQ_ADC, DMA_REQ_NONE,
+						DMA_BUFFER_SIZE, DMA_BURST_1, DMA_WIDTH_WORD, DMA_P2M,
+						(unsigned int)&sample_lli[PONG]);
+	ping_pong = PING;
+	dma_enable(SAMPLER_DMA_CHANNEL);
+	adc_enable_dma_trigger();
+	LPC_TIM0 -> TCR |= (1<<1);  //Reset Counter
+	LPC_TIM0 -> TCR &= ~(1<<1); //release reset
+	LPC_TIM0 -> TCR |= 1;
+}
+
+void sampler_stop(void) {
+
+	LPC_TIM0 -> TCR = 0;
+	adc_disable_trigger();
+	dma_disable(SAMPLER_DMA_CHANNEL);
+}
@@ -0,0 +1,39 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdint.h>
+#include "dma.h"            // DMA_BUFFER_SIZE
+
+#define SAMPLER_DMA_CHANNEL 0
+
+/**
+ * @brief Sets up timer-paced ADC sampling into DMA ping-pong buffers.
+ *
+ * TIMER0 toggles MAT0.1 at twice @p rate, each rising edge starts one ADC
+ * conversion on P_ADC and the GPDMA moves the result into one of two
+ * DMA_BUFFER_SIZE word buffers. TIMER0 is owned by the sampler from here
+ * on, so the timer.c API must not be used alongside it.
+ *
+ * @param rate Sampling rate in Hz.
+ */
+void sampler_init(uint32_t rate);
+
+/**
+ * @brief Registers the function that consumes each filled block.
+ *
+ * Called from the DMA interrupt with the buffer the DMA has just finished;
+ * it stays valid until the other buffer fills, i.e. one block period.
+ * Use ADC_RESULT() to get the 12-bit sample out of each word.
+ *
+ * @param callback Block consumer.
+ */
+void sampler_set_callback(void (*callback)(const uint32_t *block, int length));
+
+/** @brief Starts the timer and the DMA channel, from the first buffer
+ *         again after sampler_stop(). */
+void sampler_start(void);
+
+/** @brief Stops sampling and disarms the ADC trigger, leaving the ADC idle. */
+void sampler_stop(void);
+
+#endif // SAMPLER_H
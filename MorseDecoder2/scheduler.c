@@ -0,0 +1,115 @@
+#include "platform.h"
+#include "timebase.h"       // Deadlines and the wake-up alarm
+#include "scheduler.h"
+
+typedef struct {
+    void (*run)(void);
+    uint32_t period_us;     // 0 for one-shot deadlines only
+    uint32_t deadline_us;
+    int has_deadline;
+} Task;
+
+static Task tasks[SCHEDULER_TASKS];
+static int task_count = 0;
+
+// One byte per task, so that interrupts set it and the scheduler clears
+// it without a read-modify-write of shared flags. A task is cleared
+// before it runs, so a post during its run makes it run again.
+static volatile uint8_t pending[SCHEDULER_TASKS];
+
+int scheduler_add(void (*run)(void), uint32_t period_us) {
+    if (task_count == SCHEDULER_TASKS) return -1;
+
+    timebase_init();
+    Task *task = &tasks[task_count];
+    task->run = run;
+    task->period_us = period_us;
+    task->deadline_us = timebase_now_us() + period_us;
+    task->has_deadline = period_us != 0;
+    pending[task_count] = 0;
+    return task_count++;
+}
+
+void scheduler_post(int task) {
+    pending[task] = 1;
+}
+
+void scheduler_post_at(int task, uint32_t at_us) {
+    tasks[task].deadline_us = at_us;
+    tasks[task].has_deadline = 1;
+}
+
+// Marks every task whose deadline has passed as pending and moves its
+// deadline on. Periodic deadlines advance by whole periods, so that a late
+// run does not shift the ones after it.
+static void release_due(uint32_t now) {
+    for (int i = 0; i < task_count; i++) {
+        Task *task = &tasks[i];
+        if (!task->has_deadline || (int32_t)(now - task->deadline_us) < 0) continue;
+
+        pending[i] = 1;
+        if (task->period_us == 0) {
+            task->has_deadline = 0;
+            continue;
+        }
+        do {
+            task->deadline_us += task->period_us;
+        } while ((int32_t)(now - task->deadline_us) >= 0);
+    }
+}
+
+// Runs the first pending task.
+// @return 1 if a task ran, 0 if none was pending.
+static int run_one(void) {
+    for (int i = 0; i < task_count; i++) {
+        if (pending[i]) {
+            pending[i] = 0;
+            tasks[i].run();
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int any_pending(void) {
+    for (int i = 0; i < task_count; i++) {
+        if (pending[i]) return 1;
+    }
+    return 0;
+}
+
+// Sleeps until the earliest deadline, or any interrupt before it.
+static void sleep_until_next(void) {
+    int found = 0;
+    uint32_t next = 0;
+    uint32_t now = timebase_now_us();
+
+    for (int i = 0; i < task_count; i++) {
+        if (tasks[i].has_deadline && (!found || (int32_t)(tasks[i].deadline_us - next) < 0)) {
+            next = tasks[i].deadline_us;
+            found = 1;
+        }
+    }
+    if (found) {
+        if ((int32_t)(next - now) <= 0) return;
+        timebase_alarm(AlarmScheduler, next, 0);
+    } else {
+        timebase_cancel(AlarmScheduler);
+    }
+
+    // A post between the check and __WFI() still wakes the CPU: with
+    // interrupts masked the pending interrupt ends the sleep, and its
+    // handler runs once they are unmasked.
+    __disable_irq();
+    if (!any_pending()) __WFI();
+    __enable_irq();
+}
+
+void scheduler_run(void) {
+    while (1) {
+        release_due(timebase_now_us());
+        if (!run_one()) {
+            sleep_until_next();
+        }
+    }
+}
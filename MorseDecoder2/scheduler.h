@@ -0,0 +1,37 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+#define SCHEDULER_TASKS 8
+
+/**
+ * Run-to-completion tasks. A task runs when it has been posted, e.g. by
+ * an interrupt handing it work, or when its deadline on the timebase (see
+ * timebase.h) has passed. Tasks never preempt each other: each one runs to
+ * its end, and the ready task added first runs first. With nothing ready
+ * the CPU sleeps in __WFI() until the next deadline or interrupt.
+ */
+
+/**
+ * @brief Adds a task.
+ * @param run       Task body.
+ * @param period_us Run every @p period_us from now on, 0 for a task that
+ *                  only runs when posted or given a deadline.
+ * @return Task id for scheduler_post(), -1 if all SCHEDULER_TASKS are used.
+ */
+int scheduler_add(void (*run)(void), uint32_t period_us);
+
+/** @brief Runs @p task as soon as possible. Safe from interrupts. */
+void scheduler_post(int task);
+
+/**
+ * @brief Runs @p task once at @p at_us, as timebase_now_us(), in place
+ *        of any deadline it had. Call from tasks only.
+ */
+void scheduler_post_at(int task, uint32_t at_us);
+
+/** @brief Runs the tasks forever. */
+void scheduler_run(void);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,90 @@
+#include "morse.h"
+#include "soft.h"
+
+#define COST_SHIFT    8             // Costs are Q8
+#define COST_MAX_REL  (4 << COST_SHIFT)
+#define COST_NONE     INT32_MAX
+
+// Squared distance of a duration to a cluster centroid in units of the
+// shorter cluster of its pair, Q8. Dots and dashes (or element and letter
+// gaps) are modelled with the same spread, so that on its own every
+// element is still split at the midpoint of its two centroids.
+static int32_t cost(uint32_t duration, int32_t centroid, int32_t unit) {
+    int32_t rel = (int32_t)(((int64_t)duration - centroid) * (1 << COST_SHIFT) / unit);
+    if (rel < 0) rel = -rel;
+    if (rel > COST_MAX_REL) rel = COST_MAX_REL;
+    return (rel * rel) >> COST_SHIFT;
+}
+
+void soft_init(SoftWord *word) {
+    word->marks = 0;
+}
+
+void soft_mark(SoftWord *word, uint32_t duration_us) {
+    if (word->marks >= SOFT_MAX_MARKS) return;
+    word->mark_us[word->marks] = duration_us;
+    word->gap_us[word->marks] = 0;
+    word->marks++;
+}
+
+void soft_space(SoftWord *word, uint32_t duration_us) {
+    if (word->marks == 0) return;
+    word->gap_us[word->marks - 1] += duration_us;
+}
+
+int soft_decode(const SoftWord *word, const SpeedTracker *st, char *text, int max) {
+    int marks = word->marks;
+    int32_t dot_cost[SOFT_MAX_MARKS], dash_cost[SOFT_MAX_MARKS];
+    int32_t element_cost[SOFT_MAX_MARKS], letter_cost[SOFT_MAX_MARKS];
+    // best[i]: lowest cost of the first i marks as whole characters,
+    // reached by a character spanning marks from[i] to i - 1
+    int32_t best[SOFT_MAX_MARKS + 1];
+    uint8_t from[SOFT_MAX_MARKS + 1];
+    char letter[SOFT_MAX_MARKS + 1];
+
+    for (int i = 0; i < marks; i++) {
+        dot_cost[i] = cost(word->mark_us[i], st->dot, st->dot);
+        dash_cost[i] = cost(word->mark_us[i], st->dash, st->dot);
+        element_cost[i] = cost(word->gap_us[i], st->element_gap, st->element_gap);
+        letter_cost[i] = cost(word->gap_us[i], st->letter_gap, st->element_gap);
+    }
+
+    best[0] = 0;
+    for (int i = 1; i <= marks; i++) {
+        best[i] = COST_NONE;
+        int32_t inside = 0;         // Element gaps between marks j .. i - 1
+        for (int length = 1; length <= MORSE_MAX_ELEMENTS && length <= i; length++) {
+            int j = i - length;
+            if (length > 1) inside += element_cost[j];
+
+            int32_t base = best[j] + inside + (j > 0 ? letter_cost[j - 1] : 0);
+
+            // Cheapest labelling of marks j .. i - 1 that is a character
+            for (int node = 1 << length; node < 2 << length; node++) {
+                char c = morse_char(node);
+                if (c == '#') continue;
+
+                int32_t total = base;
+                for (int k = 0; k < length; k++) {
+                    int dash = (node >> (length - 1 - k)) & 1;
+                    total += dash ? dash_cost[j + k] : dot_cost[j + k];
+                }
+                if (total < best[i]) {
+                    best[i] = total;
+                    from[i] = j;
+                    letter[i] = c;
+                }
+            }
+        }
+    }
+
+    // Walk the chosen split back from the end of the word
+    int count = 0;
+    for (int i = marks; i > 0; i = from[i]) count++;
+
+    int n = count;
+    for (int i = marks; i > 0; i = from[i]) {
+        if (--n < max) text[n] = letter[i];
+    }
+    return count < max ? count : max;
+}
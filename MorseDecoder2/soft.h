@@ -0,0 +1,47 @@
+#ifndef SOFT_H
+#define SOFT_H
+
+#include <stdint.h>
+#include "speed.h"          // SpeedTracker
+
+#define SOFT_MAX_MARKS 40   // Marks per word kept for the search
+
+/** Raw timing of the word being received, one gap after each mark. */
+typedef struct {
+    uint32_t mark_us[SOFT_MAX_MARKS];
+    uint32_t gap_us[SOFT_MAX_MARKS];
+    int marks;
+} SoftWord;
+
+/** @brief Starts a new word. */
+void soft_init(SoftWord *word);
+
+/** @brief Appends a mark. Marks beyond SOFT_MAX_MARKS are dropped. */
+void soft_mark(SoftWord *word, uint32_t duration_us);
+
+/**
+ * @brief Adds silence after the last mark. Silence split by a dropped
+ *        glitch is added up; silence before the first mark is ignored.
+ */
+void soft_space(SoftWord *word, uint32_t duration_us);
+
+/**
+ * @brief Finds the most likely text for the word so far.
+ *
+ * Every mark is scored as a dot and as a dash, and every gap inside the
+ * word as an element and as a letter gap, by its squared distance to the
+ * cluster centroids of @p st in dot lengths. A Viterbi search
+ * over the Morse tree then picks the split into characters and the
+ * element labels with the lowest total cost, considering only codes that
+ * are characters. The silence after the last mark is taken as a letter
+ * gap.
+ *
+ * @param word Timing of the word.
+ * @param st   Current speed estimate.
+ * @param text Receives the characters, not terminated.
+ * @param max  Room in @p text.
+ * @return Number of characters written.
+ */
+int soft_decode(const SoftWord *word, const SpeedTracker *st, char *text, int max);
+
+#endif // SOFT_H
@@ -0,0 +1,68 @@
+#include "speed.h"
+
+// Moves the centroid of the matched cluster towards the new duration.
+// The short cluster follows shorter durations faster than longer ones,
+// so that after a jump in speed the new long elements are not averaged
+// into it and it cannot settle above them. The unmatched centroid is
+// drawn slowly towards the 1:3 ratio, so that a stream of only dots or
+// only dashes still follows a change of speed.
+static void update_pair(int32_t *shorter, int32_t *longer, int32_t duration, int is_long) {
+    if (is_long) {
+        *longer += (duration - *longer) >> SPEED_SHIFT;
+        *shorter += (*longer / 3 - *shorter) >> (SPEED_SHIFT + 2);
+    } else {
+        int shift = duration < *shorter ? SPEED_SHIFT - 1 : SPEED_SHIFT + 1;
+        *shorter += (duration - *shorter) >> shift;
+        *longer += (*shorter * 3 - *longer) >> (SPEED_SHIFT + 2);
+    }
+
+    // Keep the clusters apart and inside the supported speed range
+    if (*shorter < SPEED_DOT_US(SPEED_MAX_WPM)) *shorter = SPEED_DOT_US(SPEED_MAX_WPM);
+    if (*shorter > SPEED_DOT_US(SPEED_MIN_WPM)) *shorter = SPEED_DOT_US(SPEED_MIN_WPM);
+    if (*longer < 2 * *shorter) *longer = 2 * *shorter;
+    if (*longer > 5 * *shorter) *longer = 5 * *shorter;
+}
+
+void speed_init(SpeedTracker *st) {
+    st->dot = SPEED_DOT_US(SPEED_INITIAL_WPM);
+    st->dash = 3 * st->dot;
+    st->element_gap = st->dot;
+    st->letter_gap = 3 * st->dot;
+}
+
+int speed_mark(SpeedTracker *st, int32_t duration_us) {
+    if (duration_us < SPEED_GLITCH_US) return SPEED_GLITCH;
+
+    int dash = duration_us >= (st->dot + st->dash) / 2;
+    update_pair(&st->dot, &st->dash, duration_us, dash);
+    return dash;
+}
+
+void speed_space(SpeedTracker *st, int32_t duration_us) {
+    if (duration_us >= speed_word_gap(st)) return;
+
+    int letter = duration_us >= speed_letter_gap(st);
+    update_pair(&st->element_gap, &st->letter_gap, duration_us, letter);
+}
+
+int32_t speed_unit(const SpeedTracker *st) {
+    return (st->dot + st->dash / 3) / 2;
+}
+
+int32_t speed_letter_gap(const SpeedTracker *st) {
+    return (st->element_gap + st->letter_gap) / 2;
+}
+
+int32_t speed_word_gap(const SpeedTracker *st) {
+    // Midway between a 3 unit letter gap and a 7 unit word gap, measured
+    // from the marks so that a run of letter gaps taken for word gaps
+    // cannot hold the space clusters back
+    int32_t from_marks = 5 * speed_unit(st);
+    int32_t from_spaces = st->letter_gap * 5 / 3;
+    return from_spaces > from_marks ? from_spaces : from_marks;
+}
+
+int speed_wpm(const SpeedTracker *st) {
+    int32_t unit = speed_unit(st);
+    return (SPEED_DOT_US(1) + unit / 2) / unit;
+}
@@ -0,0 +1,55 @@
+#ifndef SPEED_H
+#define SPEED_H
+
+#include <stdint.h>
+
+#define SPEED_INITIAL_WPM 25
+#define SPEED_MIN_WPM     5
+#define SPEED_MAX_WPM     60
+#define SPEED_SHIFT       2     // Cluster centroids move 1/4 of the way per element
+
+// PARIS timing: one dot lasts 1200 ms / WPM
+#define SPEED_DOT_US(wpm) (1200000 / (wpm))
+
+#define SPEED_GLITCH      (-1)
+#define SPEED_GLITCH_US   (SPEED_DOT_US(SPEED_MAX_WPM) / 2)  // Shorter marks are noise
+
+/**
+ * Online two-cluster estimate of the sender's timing. Marks are split
+ * into dots and dashes, spaces into element and letter gaps, each pair
+ * around the midpoint of its two centroids. Word gaps and longer
+ * silences do not move the estimate. All durations are in microseconds.
+ */
+typedef struct {
+    int32_t dot;
+    int32_t dash;
+    int32_t element_gap;
+    int32_t letter_gap;
+} SpeedTracker;
+
+/** @brief Starts from nominal SPEED_INITIAL_WPM timing. */
+void speed_init(SpeedTracker *st);
+
+/**
+ * @brief Classifies a completed mark and updates the mark clusters.
+ * @return 0 for a dot, 1 for a dash, SPEED_GLITCH for a mark shorter
+ *         than SPEED_GLITCH_US, which is ignored.
+ */
+int speed_mark(SpeedTracker *st, int32_t duration_us);
+
+/** @brief Updates the space clusters with a completed space. */
+void speed_space(SpeedTracker *st, int32_t duration_us);
+
+/** @brief Estimated dot length in microseconds. */
+int32_t speed_unit(const SpeedTracker *st);
+
+/** @brief Silence after which the symbol in progress is complete. */
+int32_t speed_letter_gap(const SpeedTracker *st);
+
+/** @brief Silence after which the word in progress is complete. */
+int32_t speed_word_gap(const SpeedTracker *st);
+
+/** @brief Estimated sending speed in words per minute. */
+int speed_wpm(const SpeedTracker *st);
+
+#endif // SPEED_H
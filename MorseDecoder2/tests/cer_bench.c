@@ -0,0 +1,152 @@
+// Character error rate of the decoder on synthetic Morse: words drawn
+// from a corpus, keyed at BENCH_WPM with Gaussian jitter on every mark
+// and space, fed to decoder_event() and compared with the sent text by
+// edit distance. Built once per DECODER_SOFT_DECISION setting; `make
+// bench` in this directory prints both columns.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "morse.h"
+#include "decoder.h"
+
+#define BENCH_WPM    20
+#define BENCH_WORDS  300      // Words per jitter level
+#define MAX_CORPUS   512
+#define MAX_TEXT     (BENCH_WORDS * 12)
+
+static const int jitters[] = {10, 15, 20, 25, 30};  // Percent of each duration
+
+static char corpus[MAX_CORPUS][16];
+static int corpus_size = 0;
+
+// Deterministic, so that every build sees the same signal
+static uint32_t seed;
+static double uniform(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return ((seed >> 8) + 0.5) / 16777216.0;
+}
+
+static double gaussian(void) {
+    return sqrt(-2 * log(uniform())) * cos(2 * M_PI * uniform());
+}
+
+static void load_corpus(const char *path) {
+    FILE *file = fopen(path, "r");
+    char line[64];
+
+    if (!file) {
+        perror(path);
+        exit(2);
+    }
+    while (corpus_size < MAX_CORPUS && fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!line[0]) continue;
+        if (strlen(line) >= sizeof(corpus[0])) {
+            fprintf(stderr, "%s: word too long: %s\n", path, line);
+            exit(2);
+        }
+        for (const char *c = line; *c; c++) {
+            if (morse_encode(*c) == MORSE_INVALID) {
+                fprintf(stderr, "%s: no code for '%c' in %s\n", path, *c, line);
+                exit(2);
+            }
+        }
+        strcpy(corpus[corpus_size++], line);
+    }
+    fclose(file);
+}
+
+// Decoded text made final so far, kept whole past the decoder's buffer
+static char received[MAX_TEXT];
+static int received_length;
+static uint32_t received_to;    // Position in the decoder's text, as dec->dropped
+
+static void collect(const Decoder *dec) {
+    if (received_to < dec->dropped) received_to = dec->dropped;
+    while (received_to < dec->dropped + dec->word_start && received_length < MAX_TEXT - 1) {
+        received[received_length++] = dec->text[received_to - dec->dropped];
+        received_to++;
+    }
+    received[received_length] = '\0';
+}
+
+static void send(Decoder *dec, int mark, double units, double jitter) {
+    double dot_us = SPEED_DOT_US(BENCH_WPM);
+    double us = units * dot_us * (1 + jitter * gaussian());
+    MorseEvent event;
+
+    if (us < dot_us / 10) us = dot_us / 10;
+    event.mark = mark;
+    event.channel = 0;
+    event.duration_us = (uint32_t)us;
+    decoder_event(dec, &event);
+    collect(dec);
+}
+
+static void send_code(Decoder *dec, int node, double jitter) {
+    int length = 0;
+
+    while ((node >> length) > MORSE_ROOT) length++;
+    for (int i = length - 1; i >= 0; i--) {
+        send(dec, 1, (node >> i) & 1 ? 3 : 1, jitter);
+        if (i) send(dec, 0, 1, jitter);
+    }
+}
+
+static int edit_distance(const char *a, const char *b) {
+    int n = strlen(b);
+    int *row = malloc((n + 1) * sizeof(int));
+
+    for (int j = 0; j <= n; j++) row[j] = j;
+    for (const char *p = a; *p; p++) {
+        int diagonal = row[0];
+        row[0]++;
+        for (int j = 1; j <= n; j++) {
+            int above = row[j];
+            int best = diagonal + (*p != b[j - 1]);
+            if (above + 1 < best) best = above + 1;
+            if (row[j - 1] + 1 < best) best = row[j - 1] + 1;
+            row[j] = best;
+            diagonal = above;
+        }
+    }
+    int distance = row[n];
+    free(row);
+    return distance;
+}
+
+// Character error rate in percent of the sent text, spaces included.
+static double run(double jitter) {
+    static char sent[MAX_TEXT];
+    int sent_length = 0;
+    Decoder dec;
+
+    decoder_init(&dec);
+    received_length = 0;
+    received_to = 0;
+    for (int w = 0; w < BENCH_WORDS; w++) {
+        const char *word = corpus[(int)(uniform() * corpus_size)];
+        for (const char *c = word; *c; c++) {
+            send_code(&dec, morse_encode(*c), jitter);
+            send(&dec, 0, c[1] ? 3 : 7, jitter);
+        }
+        sent_length += sprintf(sent + sent_length, "%s ", word);
+    }
+    send(&dec, 0, 20, 0);   // Long enough to end the last word
+
+    return 100.0 * edit_distance(sent, received) / sent_length;
+}
+
+int main(int argc, char **argv) {
+    load_corpus(argc > 1 ? argv[1] : "cer_words.txt");
+
+    printf("%s decoder, %d words at %d WPM per level\n",
+           DECODER_SOFT_DECISION ? "soft" : "threshold", BENCH_WORDS, BENCH_WPM);
+    for (unsigned j = 0; j < sizeof(jitters) / sizeof(jitters[0]); j++) {
+        seed = 2024 + jitters[j];   // Same words and jitter for both decoders
+        printf("  jitter %2d%%  CER %6.2f%%\n", jitters[j], run(jitters[j] / 100.0));
+    }
+    return 0;
+}
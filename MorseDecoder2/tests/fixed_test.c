@@ -0,0 +1,367 @@
+// Checks the Q15/Q30 signal path against a double precision reference:
+// ADC conversion, the Goertzel bank powers, the band-pass pre-filter, the
+// sliding envelope, the noise floor thresholds and the mark/space
+// decision they drive. Build and run on the host with `make` in this
+// directory.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "fixed.h"
+#include "goertzel.h"
+#include "envelope.h"
+#include "bandpass.h"
+#include "noise.h"
+
+#define TONES        200
+#define MAX_REL_ERR  0.05   // Goertzel power of bins within 10 dB of the block's peak
+#define MAX_LEAK_ERR 0.01   // Error of the other bins, relative to the peak
+#define NEAR_TIE     0.05   // Relative gap below which either top bin may win
+#define MAX_BIQUAD_ERR 32   // Q15 LSB: rounding of each stage, amplified by poles near the unit circle
+#define MAX_PEAK_GAIN_ERR 0.05 // Band-pass gain at the centre of its bin
+#define MAX_MIDPOINT_ERR 2  // ADC counts: the tracker rounds down when updating and when reading
+#define MAX_ENV_THR_ERR 6   // Q15 LSB: the same two roundings, times ENV_ON_RATIO
+#define MAX_POWER_THR_ERR 0.01 // Relative, tone power threshold against the float tracker
+#define MIN_AGREEMENT 0.995 // Samples with the same mark/space decision as the float path
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { failures++; printf("FAIL: " __VA_ARGS__); printf("\n"); } \
+} while (0)
+
+// Deterministic, so that a failure can be reproduced
+static uint32_t seed = 12345;
+static double uniform(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / 16777216.0;
+}
+
+static double q15_to_double(q15_t x) {
+    return x / 32768.0;
+}
+
+// Every raw code must convert to the saturated Q15 of its offset.
+static void test_adc_conversion(void) {
+    const int mids[] = {0, 1000, 2048, 4095};
+
+    for (unsigned m = 0; m < sizeof(mids) / sizeof(mids[0]); m++) {
+        for (int raw = 0; raw <= (int)ADC_MASK; raw++) {
+            double ref = (raw - mids[m]) / (double)(1 << (ADC_BITS - 1));
+            if (ref > 32767 / 32768.0) ref = 32767 / 32768.0;
+            if (ref < -1.0) ref = -1.0;
+            q15_t got = Q15_FROM_ADC(raw, mids[m]);
+            CHECK(q15_to_double(got) == ref, "Q15_FROM_ADC(%d, %d) = %d", raw, mids[m], got);
+        }
+    }
+}
+
+// Normalised as goertzel_bank_process(): |X|^2 / (n/2)^2, in Q30 units.
+static double reference_power(const q15_t *x, int n, double hz) {
+    double coeff = 2 * cos(2 * M_PI * hz / GOERTZEL_FS);
+    double s1 = 0, s2 = 0;
+
+    for (int i = 0; i < n; i++) {
+        double s0 = q15_to_double(x[i]) + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    double power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+    return power / ((n / 2.0) * (n / 2.0)) * (1 << 30);
+}
+
+// Random tones, amplitudes and phases over every block length in use.
+static void test_goertzel_bank(void) {
+    const int lengths[] = {64, 128, 256};
+    q15_t x[256];
+    double worst = 0;
+
+    for (int t = 0; t < TONES; t++) {
+        int n = lengths[t % 3];
+        double hz = GOERTZEL_F_MIN + uniform() * (GOERTZEL_F_MAX - GOERTZEL_F_MIN);
+        double counts = 10 + uniform() * 1500;
+        double phase = uniform() * 2 * M_PI;
+        GoertzelBank bank;
+
+        for (int i = 0; i < n; i++) {
+            double noise = (uniform() - 0.5) * 8;
+            int raw = 2048 + (int)lround(counts * sin(2 * M_PI * hz * i / GOERTZEL_FS + phase) + noise);
+            x[i] = Q15_FROM_ADC(raw, 2048);
+        }
+
+        double ref[GOERTZEL_BINS];
+        int strongest = 0;
+        for (int b = 0; b < GOERTZEL_BINS; b++) {
+            ref[b] = reference_power(x, n, GOERTZEL_F_MIN + b * GOERTZEL_F_STEP);
+            if (ref[b] > ref[strongest]) strongest = b;
+        }
+        double peak = ref[strongest];
+
+        goertzel_bank_init(&bank);
+        goertzel_bank_process(&bank, x, n, 0);
+        for (int b = 0; b < GOERTZEL_BINS; b++) {
+            double err = fabs(bank.power[b] - ref[b]);
+            if (ref[b] >= peak / 10) {
+                if (err / ref[b] > worst) worst = err / ref[b];
+                CHECK(err / ref[b] <= MAX_REL_ERR, "tone %.1f Hz, %d samples, bin %d: %u vs %.0f",
+                      hz, n, b, bank.power[b], ref[b]);
+            } else {
+                CHECK(err <= MAX_LEAK_ERR * peak, "tone %.1f Hz, %d samples, leaking bin %d: %u vs %.0f",
+                      hz, n, b, bank.power[b], ref[b]);
+            }
+        }
+        CHECK(bank.strongest == strongest || ref[bank.strongest] >= peak * (1 - NEAR_TIE),
+              "tone %.1f Hz, %d samples: strongest bin %d vs %d", hz, n, bank.strongest, strongest);
+    }
+    printf("goertzel: %d tones, worst relative error near the peak %.2f%%\n", TONES, worst * 100);
+}
+
+// The window mean must match the float mean of the last samples, rounded
+// down, including at full scale where it saturates.
+static void test_envelope(void) {
+    Envelope env;
+    int32_t history[ENVELOPE_WINDOW] = {0};
+
+    envelope_init(&env);
+    for (int i = 0; i < 10 * ENVELOPE_WINDOW; i++) {
+        int32_t rectified = i >= 8 * ENVELOPE_WINDOW ? 32768 : (int32_t)(uniform() * 32768);
+        history[i % ENVELOPE_WINDOW] = rectified;
+
+        double mean = 0;
+        for (int k = 0; k < ENVELOPE_WINDOW; k++) {
+            mean += history[k];
+        }
+        mean /= ENVELOPE_WINDOW;
+        if (mean > 32767) mean = 32767;
+
+        q15_t got = envelope_update(&env, rectified);
+        CHECK(got == (q15_t)floor(mean), "envelope sample %d: %d vs %.2f", i, got, mean);
+    }
+}
+
+// Float cascade of the same coefficients, i.e. the exact value the stored
+// Q15 numbers stand for: {b0, 0, b1, b2, -a1, -a2} halved.
+typedef struct {
+    double c[6];
+    double x1[BANDPASS_STAGES], x2[BANDPASS_STAGES], y1[BANDPASS_STAGES], y2[BANDPASS_STAGES];
+} FloatBandPass;
+
+static void float_bandpass_init(FloatBandPass *f, const BandPass *bp) {
+    for (int i = 0; i < 6; i++) {
+        f->c[i] = bp->coeff[i] * 2 / 32768.0;
+    }
+    for (int s = 0; s < BANDPASS_STAGES; s++) {
+        f->x1[s] = f->x2[s] = f->y1[s] = f->y2[s] = 0;
+    }
+}
+
+static double float_bandpass(FloatBandPass *f, double x) {
+    for (int s = 0; s < BANDPASS_STAGES; s++) {
+        double y = f->c[0] * x + f->c[2] * f->x1[s] + f->c[3] * f->x2[s]
+                 + f->c[4] * f->y1[s] + f->c[5] * f->y2[s];
+        f->x2[s] = f->x1[s];
+        f->x1[s] = x;
+        f->y2[s] = f->y1[s];
+        f->y1[s] = y;
+        x = y;
+    }
+    return x;
+}
+
+// Every pass band, wide included, fed a tone in noise block by block so
+// that the state carries over: the output must track the float cascade,
+// and a tone at the centre of a bin must pass at unity gain.
+static void test_bandpass(void) {
+    double worst = 0;
+
+    for (int bin = BANDPASS_WIDE; bin < GOERTZEL_BINS; bin++) {
+        double centre = bin == BANDPASS_WIDE ? 490 : GOERTZEL_F_MIN + bin * GOERTZEL_F_STEP;
+        double amplitude = 0.3 + uniform() * 0.3;
+        double peak_in = 0, peak_out = 0;
+        BandPass bp;
+        FloatBandPass ref;
+
+        bandpass_init(&bp, bin);
+        float_bandpass_init(&ref, &bp);
+        for (int block = 0; block < 32; block++) {
+            q15_t x[128], y[128];
+            for (int i = 0; i < 128; i++) {
+                int n = block * 128 + i;
+                double noise = (uniform() - 0.5) * 0.02;
+                x[i] = (q15_t)lround(32767 * (amplitude * sin(2 * M_PI * centre * n / GOERTZEL_FS) + noise));
+            }
+            bandpass_process(&bp, x, y, 128);
+            for (int i = 0; i < 128; i++) {
+                double want = float_bandpass(&ref, q15_to_double(x[i])) * 32768;
+                double err = fabs(y[i] - want);
+                if (err > worst) worst = err;
+                CHECK(err <= MAX_BIQUAD_ERR, "band-pass bin %d sample %d: %d vs %.1f", bin, block * 128 + i, y[i], want);
+                // Settled after the first half
+                if (block >= 16) {
+                    if (fabs(x[i]) > peak_in) peak_in = fabs(x[i]);
+                    if (fabs(y[i]) > peak_out) peak_out = fabs(y[i]);
+                }
+            }
+        }
+        if (bin != BANDPASS_WIDE) {
+            CHECK(fabs(peak_out / peak_in - 1) <= MAX_PEAK_GAIN_ERR, "band-pass bin %d: gain %.3f at %.0f Hz",
+                  bin, peak_out / peak_in, centre);
+        }
+    }
+    printf("band-pass: worst error against the float cascade %.0f LSB\n", worst);
+}
+
+// Float tracker of the same statistics: a plain mean over the calibration
+// blocks, then an exponential average over idle blocks.
+typedef struct {
+    double midpoint, env_floor, power_floor;
+    int blocks;
+} FloatNoise;
+
+static void float_noise_update(FloatNoise *f, int raw_mean, q15_t env_mean, uint32_t power, int idle) {
+    double weight;
+
+    if (f->blocks >= NOISE_CAL_BLOCKS && !idle) return;
+    weight = f->blocks < NOISE_CAL_BLOCKS ? 1.0 / (f->blocks + 1) : 1.0 / (1 << NOISE_TRACK_SHIFT);
+    f->midpoint += (raw_mean - f->midpoint) * weight;
+    f->env_floor += (env_mean - f->env_floor) * weight;
+    f->power_floor += (power - f->power_floor) * weight;
+    if (f->blocks < NOISE_CAL_BLOCKS) f->blocks++;
+}
+
+static double float_tone_threshold(const FloatNoise *f) {
+    double t = 8 * f->power_floor;
+    return t > Q30_FROM_COUNTS(20) ? t : Q30_FROM_COUNTS(20);
+}
+
+static double float_env_on(const FloatNoise *f) {
+    double t = 3 * f->env_floor;
+    if (t < Q15_FROM_COUNTS(12)) t = Q15_FROM_COUNTS(12);
+    return t > 32767 ? 32767 : t;
+}
+
+static double float_env_off(const FloatNoise *f) {
+    double t = 2 * f->env_floor;
+    if (t < Q15_FROM_COUNTS(8)) t = Q15_FROM_COUNTS(8);
+    return t > 32767 ? 32767 : t;
+}
+
+// Block statistics of inputs from near silence to loud noise, a fraction
+// of them with a tone, through calibration and tracking.
+static void test_noise(void) {
+    const double levels[] = {0.5, 5, 50, 400};
+    double worst_env = 0, worst_power = 0;
+
+    for (unsigned l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        NoiseTracker nt;
+        FloatNoise ref = {ADC_MASK / 2 + 1, 0, 0, 0};
+
+        noise_init(&nt);
+        for (int block = 0; block < 400; block++) {
+            double level = levels[l] * (0.5 + uniform());
+            int idle = block < NOISE_CAL_BLOCKS || uniform() < 0.7;
+            int raw_mean = 2000 + (int)(uniform() * 100);
+            q15_t env_mean = (q15_t)(Q15_FROM_COUNTS(1) * level * (idle ? 1 : 20));
+            uint32_t power = (uint32_t)(Q30_FROM_COUNTS(1) * level * level * (idle ? 1 : 400));
+
+            noise_update(&nt, raw_mean, env_mean, power, idle);
+            float_noise_update(&ref, raw_mean, env_mean, power, idle);
+            if (noise_calibrating(&nt)) continue;
+
+            double on_err = fabs(noise_env_on(&nt) - float_env_on(&ref));
+            double off_err = fabs(noise_env_off(&nt) - float_env_off(&ref));
+            double power_err = fabs(noise_tone_threshold(&nt) - float_tone_threshold(&ref)) / float_tone_threshold(&ref);
+            if (on_err > worst_env) worst_env = on_err;
+            if (off_err > worst_env) worst_env = off_err;
+            if (power_err > worst_power) worst_power = power_err;
+            CHECK(fabs(noise_midpoint(&nt) - ref.midpoint) <= MAX_MIDPOINT_ERR, "noise level %.1f block %d: midpoint %d vs %.2f",
+                  levels[l], block, noise_midpoint(&nt), ref.midpoint);
+            CHECK(on_err <= MAX_ENV_THR_ERR && off_err <= MAX_ENV_THR_ERR, "noise level %.1f block %d: on/off %d/%d vs %.1f/%.1f",
+                  levels[l], block, noise_env_on(&nt), noise_env_off(&nt), float_env_on(&ref), float_env_off(&ref));
+            CHECK(power_err <= MAX_POWER_THR_ERR, "noise level %.1f block %d: tone threshold %u vs %.0f",
+                  levels[l], block, noise_tone_threshold(&nt), float_tone_threshold(&ref));
+        }
+    }
+    printf("noise: worst envelope threshold error %.0f LSB, tone threshold %.2f%%\n", worst_env, worst_power * 100);
+}
+
+// A keyed 500 Hz tone in noise through both whole paths: ADC conversion,
+// band-pass, envelope, thresholds from the noise floor and the decision
+// with hysteresis, as on_sample_block() with the block taken as tone.
+static void test_decision(void) {
+    const int block_length = 128;
+    const int bin = GOERTZEL_BIN(500);
+    BandPass bp;
+    FloatBandPass ref_bp;
+    Envelope env;
+    NoiseTracker nt;
+    FloatNoise ref_nt = {ADC_MASK / 2 + 1, 0, 0, 0};
+    double history[ENVELOPE_WINDOW] = {0};
+    int mark = 0, ref_mark = 0, agree = 0, total = 0, edges = 0, ref_edges = 0;
+
+    bandpass_init(&bp, bin);
+    float_bandpass_init(&ref_bp, &bp);
+    envelope_init(&env);
+    noise_init(&nt);
+    for (int block = 0; block < 200; block++) {
+        // Idle while calibrating, then 4 blocks on and 3 off
+        int keyed = block >= NOISE_CAL_BLOCKS && (block % 7) < 4;
+        int midpoint = noise_midpoint(&nt);
+        q15_t on = noise_env_on(&nt), off = noise_env_off(&nt);
+        double ref_on = float_env_on(&ref_nt), ref_off = float_env_off(&ref_nt);
+        int32_t env_sum = 0;
+        double ref_env_sum = 0;
+        uint32_t raw_sum = 0;
+
+        for (int i = 0; i < block_length; i++) {
+            int n = block * block_length + i;
+            double tone = keyed ? 300 * sin(2 * M_PI * 500 * n / GOERTZEL_FS) : 0;
+            int raw = 2048 + (int)lround(tone + (uniform() - 0.5) * 40);
+            raw_sum += raw;
+
+            q15_t x = Q15_FROM_ADC(raw, midpoint), y;
+            bandpass_process(&bp, &x, &y, 1);
+            int32_t rectified = y < 0 ? -(int32_t)y : y;
+            q15_t e = envelope_update(&env, rectified);
+            env_sum += e;
+
+            double ref_y = float_bandpass(&ref_bp, (raw - ref_nt.midpoint) / (double)(1 << (ADC_BITS - 1)));
+            history[n % ENVELOPE_WINDOW] = fabs(ref_y) * 32768;
+            double ref_e = 0;
+            for (int k = 0; k < ENVELOPE_WINDOW; k++) ref_e += history[k];
+            ref_e /= ENVELOPE_WINDOW;
+            ref_env_sum += ref_e;
+
+            int next = keyed && e > (mark ? off : on);
+            int ref_next = keyed && ref_e > (ref_mark ? ref_off : ref_on);
+            edges += next != mark;
+            ref_edges += ref_next != ref_mark;
+            mark = next;
+            ref_mark = ref_next;
+            agree += mark == ref_mark;
+            total++;
+        }
+        // The power is only a stand-in here, the tone gate is not under test
+        noise_update(&nt, raw_sum / block_length, (q15_t)(env_sum / block_length), 0, !keyed);
+        float_noise_update(&ref_nt, raw_sum / block_length, (q15_t)lround(ref_env_sum / block_length), 0, !keyed);
+    }
+    CHECK(agree >= MIN_AGREEMENT * total, "decision: %d of %d samples agree", agree, total);
+    CHECK(edges == ref_edges, "decision: %d mark/space changes vs %d", edges, ref_edges);
+    printf("decision: %.2f%% of samples agree, %d changes\n", 100.0 * agree / total, edges);
+}
+
+int main(void) {
+    test_adc_conversion();
+    test_goertzel_bank();
+    test_bandpass();
+    test_envelope();
+    test_noise();
+    test_decision();
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("fixed point: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,60 @@
+#ifndef HOST_ARM_MATH_H
+#define HOST_ARM_MATH_H
+
+// Host stand-in for the parts of CMSIS-DSP used by the signal path
+// sources under test.
+
+#include <stdint.h>
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+// Saturates @p val to a signed @p bits wide range, as the SSAT instruction.
+static inline int32_t __SSAT(int32_t val, uint32_t bits) {
+    int32_t max = (1 << (bits - 1)) - 1;
+    int32_t min = -max - 1;
+    return val > max ? max : val < min ? min : val;
+}
+
+// Biquad cascade, direct form I, as the portable C version of CMSIS-DSP:
+// coefficients {b0, 0, b1, b2, a1, a2} per stage, state {x[n-1], x[n-2],
+// y[n-1], y[n-2]} per stage, a 64-bit accumulator shifted down by
+// 15 - postShift and saturated to Q15.
+typedef struct {
+    int8_t numStages;
+    q15_t *pState;
+    const q15_t *pCoeffs;
+    int8_t postShift;
+} arm_biquad_casd_df1_inst_q15;
+
+static inline void arm_biquad_cascade_df1_init_q15(arm_biquad_casd_df1_inst_q15 *S, uint8_t numStages,
+                                                   const q15_t *pCoeffs, q15_t *pState, int8_t postShift) {
+    S->numStages = numStages;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    S->postShift = postShift;
+    for (int i = 0; i < 4 * numStages; i++) pState[i] = 0;
+}
+
+static inline void arm_biquad_cascade_df1_q15(const arm_biquad_casd_df1_inst_q15 *S, const q15_t *pSrc,
+                                              q15_t *pDst, uint32_t blockSize) {
+    const q15_t *in = pSrc;
+
+    for (int stage = 0; stage < S->numStages; stage++) {
+        const q15_t *c = S->pCoeffs + 6 * stage;
+        q15_t *st = S->pState + 4 * stage;
+        for (uint32_t n = 0; n < blockSize; n++) {
+            int64_t acc = (int64_t)c[0] * in[n] + (int64_t)c[2] * st[0] + (int64_t)c[3] * st[1]
+                        + (int64_t)c[4] * st[2] + (int64_t)c[5] * st[3];
+            q15_t out = (q15_t)__SSAT((int32_t)(acc >> (15 - S->postShift)), 16);
+            st[1] = st[0];
+            st[0] = in[n];
+            st[3] = st[2];
+            st[2] = out;
+            pDst[n] = out;
+        }
+        in = pDst;
+    }
+}
+
+#endif // HOST_ARM_MATH_H
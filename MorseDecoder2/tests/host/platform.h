@@ -0,0 +1,12 @@
+#ifndef HOST_PLATFORM_H
+#define HOST_PLATFORM_H
+
+// Host stand-in for drivers/platform.h: only the definitions the signal
+// path sources under test use, with the board's values.
+
+#include <stdint.h>
+
+#define ADC_BITS 12
+#define ADC_MASK ((1u << ADC_BITS) - 1)
+
+#endif // HOST_PLATFORM_H